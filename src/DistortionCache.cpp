@@ -0,0 +1,261 @@
+/** @file
+    @brief On-disk cache of baked distortion grids.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "DistortionCache.h"
+#include "DistortionGrid.h"
+#include "osvr_platform.h"
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+#if defined(OSVR_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Standard includes
+#include <cstdio>           // for std::remove, std::rename
+#include <cstring>          // for std::memcmp, std::memcpy
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Bump whenever the file layout or the meaning of the stored samples changes.
+const uint32_t CACHE_VERSION = 1;
+const char CACHE_MAGIC[8] = { 'O', 'S', 'V', 'R', 'D', 'I', 'S', 'T' };
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nodeSize;
+    uint64_t key;
+    uint32_t resolution;
+    uint32_t eyeCount;
+};
+
+/**
+ * Read-only memory mapping of an entire file.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path)
+    {
+#if defined(OSVR_WINDOWS)
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (INVALID_HANDLE_VALUE == file_)
+            return;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size) || 0 == size.QuadPart)
+            return;
+
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_)
+            return;
+
+        data_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        if (data_)
+            size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+        fd_ = open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            return;
+
+        struct stat info;
+        if (0 != fstat(fd_, &info) || 0 == info.st_size)
+            return;
+
+        auto data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (MAP_FAILED == data)
+            return;
+
+        data_ = data;
+        size_ = static_cast<std::size_t>(info.st_size);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#if defined(OSVR_WINDOWS)
+        if (data_)
+            UnmapViewOfFile(data_);
+        if (mapping_)
+            CloseHandle(mapping_);
+        if (INVALID_HANDLE_VALUE != file_)
+            CloseHandle(file_);
+#else
+        if (data_)
+            munmap(data_, size_);
+        if (fd_ >= 0)
+            close(fd_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const
+    {
+        return static_cast<const char*>(data_);
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+private:
+#if defined(OSVR_WINDOWS)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/**
+ * 64-bit FNV-1a hash.
+ */
+uint64_t fnv1a(const void* data, std::size_t size, uint64_t hash)
+{
+    const auto bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+} // end anonymous namespace
+
+DistortionCache::DistortionCache(const std::string& path) : path_(path)
+{
+    // do nothing
+}
+
+uint64_t DistortionCache::makeKey(const std::string& display_description, float overfill_factor, std::size_t resolution)
+{
+    const auto res = static_cast<uint32_t>(resolution);
+    auto hash = 0xcbf29ce484222325ull;
+    hash = fnv1a(display_description.data(), display_description.size(), hash);
+    hash = fnv1a(&overfill_factor, sizeof(overfill_factor), hash);
+    hash = fnv1a(&res, sizeof(res), hash);
+    hash = fnv1a(&CACHE_VERSION, sizeof(CACHE_VERSION), hash);
+    return hash;
+}
+
+bool DistortionCache::load(uint64_t key, std::size_t resolution, std::vector<DistortionGrid>& grids) const
+{
+    if (path_.empty())
+        return false;
+
+    const MappedFile file(path_);
+    if (file.size() < sizeof(CacheHeader))
+        return false;
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (0 != std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)))
+        return false;
+    if (CACHE_VERSION != header.version || sizeof(vr::DistortionCoordinates_t) != header.nodeSize)
+        return false;
+    if (key != header.key || resolution != header.resolution || 0 == header.eyeCount)
+        return false;
+
+    const auto stride = resolution + 1;
+    const auto nodes_per_eye = stride * stride;
+    const auto expected_size = sizeof(CacheHeader) + header.eyeCount * nodes_per_eye * sizeof(vr::DistortionCoordinates_t);
+    if (file.size() != expected_size)
+        return false;
+
+    // The mapping is only guaranteed to be byte-aligned past the header, so
+    // each grid copies its samples out rather than pointing into the file.
+    std::vector<vr::DistortionCoordinates_t> nodes(nodes_per_eye);
+    grids.resize(header.eyeCount);
+    auto src = file.data() + sizeof(CacheHeader);
+    for (auto& grid : grids) {
+        std::memcpy(nodes.data(), src, nodes_per_eye * sizeof(vr::DistortionCoordinates_t));
+        grid.assign(resolution, nodes.data());
+        src += nodes_per_eye * sizeof(vr::DistortionCoordinates_t);
+    }
+
+    return true;
+}
+
+bool DistortionCache::save(uint64_t key, const std::vector<DistortionGrid>& grids) const
+{
+    if (path_.empty() || grids.empty())
+        return false;
+
+    const auto resolution = grids.front().getResolution();
+    for (const auto& grid : grids) {
+        if (grid.empty() || grid.getResolution() != resolution)
+            return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.nodeSize = sizeof(vr::DistortionCoordinates_t);
+    header.key = key;
+    header.resolution = static_cast<uint32_t>(resolution);
+    header.eyeCount = static_cast<uint32_t>(grids.size());
+
+    // Write to a temporary file first so a crash mid-write never leaves a
+    // truncated entry behind.
+    const auto temp_path = path_ + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& grid : grids) {
+            const auto& nodes = grid.getNodes();
+            out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(vr::DistortionCoordinates_t));
+        }
+
+        if (!out)
+            return false;
+    }
+
+#if defined(OSVR_WINDOWS)
+    // Windows won't rename over an existing file
+    std::remove(path_.c_str());
+#endif
+    return 0 == std::rename(temp_path.c_str(), path_.c_str());
+}
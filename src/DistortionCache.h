@@ -0,0 +1,80 @@
+/** @file
+    @brief On-disk cache of baked distortion grids.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_DistortionCache_h_GUID_2F8E6D31_5C7A_4B0E_9A14_C3E5B7D90A6F
+#define INCLUDED_DistortionCache_h_GUID_2F8E6D31_5C7A_4B0E_9A14_C3E5B7D90A6F
+
+// Internal Includes
+#include "DistortionGrid.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Stores baked distortion grids in a versioned binary file so they can
+ * be reused across driver launches.
+ *
+ * The file holds a single entry keyed by a hash of the display descriptor and
+ * the sampling parameters. A key or version mismatch is treated as a cache
+ * miss and the entry is overwritten by the next save().
+ */
+class DistortionCache {
+public:
+    /**
+     * @param path the cache file. An empty path disables the cache.
+     */
+    explicit DistortionCache(const std::string& path);
+
+    /**
+     * Computes the cache key for a display descriptor and the parameters the
+     * grids were baked with.
+     */
+    static uint64_t makeKey(const std::string& display_description, float overfill_factor, std::size_t resolution);
+
+    /**
+     * Memory-maps the cache file and copies its grids into @p grids if the
+     * stored key and resolution match.
+     *
+     * @return @c true on a cache hit.
+     */
+    bool load(uint64_t key, std::size_t resolution, std::vector<DistortionGrid>& grids) const;
+
+    /**
+     * Writes @p grids to the cache file, replacing any previous entry.
+     *
+     * @return @c true if the file was written.
+     */
+    bool save(uint64_t key, const std::vector<DistortionGrid>& grids) const;
+
+private:
+    std::string path_;
+};
+
+#endif // INCLUDED_DistortionCache_h_GUID_2F8E6D31_5C7A_4B0E_9A14_C3E5B7D90A6F
@@ -0,0 +1,212 @@
+/** @file
+    @brief Regular-grid lookup table for distortion coordinates.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "DistortionGrid.h"
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+// Standard includes
+#include <algorithm>        // for std::min
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OSVR_DISTORTION_GRID_SSE2
+#include <emmintrin.h>
+#endif
+
+// The SIMD path treats each node as six consecutive floats.
+static_assert(sizeof(vr::DistortionCoordinates_t) == 6 * sizeof(float), "Unexpected layout of vr::DistortionCoordinates_t.");
+
+namespace {
+
+/**
+ * Clamps @p t to [0, 1], sending NaN to 0 the way _mm_max_ps() does in the
+ * batch lookup, so the result is always safe to convert to a cell index.
+ */
+inline float clampToGrid(float t)
+{
+    return (t > 0.0f) ? std::min(t, 1.0f) : 0.0f;
+}
+
+} // end anonymous namespace
+
+void DistortionGrid::bake(std::size_t resolution, const DistortionFunction& distortion)
+{
+    clear();
+    if (0 == resolution || !distortion)
+        return;
+
+    const auto stride = resolution + 1;
+    const auto step = 1.0f / static_cast<float>(resolution);
+    nodes_.reserve(stride * stride);
+    for (std::size_t row = 0; row < stride; ++row) {
+        const auto v = static_cast<float>(row) * step;
+        for (std::size_t col = 0; col < stride; ++col) {
+            const auto u = static_cast<float>(col) * step;
+            nodes_.push_back(distortion(u, v));
+        }
+    }
+
+    resolution_ = resolution;
+}
+
+void DistortionGrid::assign(std::size_t resolution, const vr::DistortionCoordinates_t* nodes)
+{
+    clear();
+    if (0 == resolution || !nodes)
+        return;
+
+    const auto stride = resolution + 1;
+    nodes_.assign(nodes, nodes + stride * stride);
+    resolution_ = resolution;
+}
+
+void DistortionGrid::clear()
+{
+    resolution_ = 0;
+    nodes_.clear();
+}
+
+bool DistortionGrid::empty() const
+{
+    return nodes_.empty();
+}
+
+std::size_t DistortionGrid::getResolution() const
+{
+    return resolution_;
+}
+
+const std::vector<vr::DistortionCoordinates_t>& DistortionGrid::getNodes() const
+{
+    return nodes_;
+}
+
+vr::DistortionCoordinates_t DistortionGrid::lookup(float u, float v) const
+{
+    const auto res = static_cast<float>(resolution_);
+    const auto x = clampToGrid(u) * res;
+    const auto y = clampToGrid(v) * res;
+
+    // The last cell also owns the far edge of the grid.
+    const auto col = std::min(static_cast<std::size_t>(x), resolution_ - 1);
+    const auto row = std::min(static_cast<std::size_t>(y), resolution_ - 1);
+    const auto fx = x - static_cast<float>(col);
+    const auto fy = y - static_cast<float>(row);
+
+    const auto stride = resolution_ + 1;
+    const auto& n00 = nodes_[row * stride + col];
+    const auto& n10 = nodes_[row * stride + col + 1];
+    const auto& n01 = nodes_[(row + 1) * stride + col];
+    const auto& n11 = nodes_[(row + 1) * stride + col + 1];
+
+    const auto w00 = (1.0f - fx) * (1.0f - fy);
+    const auto w10 = fx * (1.0f - fy);
+    const auto w01 = (1.0f - fx) * fy;
+    const auto w11 = fx * fy;
+
+    vr::DistortionCoordinates_t coords;
+    for (int i = 0; i < 2; ++i) {
+        coords.rfRed[i] = w00 * n00.rfRed[i] + w10 * n10.rfRed[i] + w01 * n01.rfRed[i] + w11 * n11.rfRed[i];
+        coords.rfGreen[i] = w00 * n00.rfGreen[i] + w10 * n10.rfGreen[i] + w01 * n01.rfGreen[i] + w11 * n11.rfGreen[i];
+        coords.rfBlue[i] = w00 * n00.rfBlue[i] + w10 * n10.rfBlue[i] + w01 * n01.rfBlue[i] + w11 * n11.rfBlue[i];
+    }
+
+    return coords;
+}
+
+void DistortionGrid::lookup(const float* u, const float* v, std::size_t count, vr::DistortionCoordinates_t* coords) const
+{
+    std::size_t i = 0;
+
+#if defined(OSVR_DISTORTION_GRID_SSE2)
+    const auto stride = resolution_ + 1;
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.0f);
+    const auto res = _mm_set1_ps(static_cast<float>(resolution_));
+    const auto last_cell = _mm_set1_ps(static_cast<float>(resolution_ - 1));
+
+    for (; i + 4 <= count; i += 4) {
+        // Cell indices and weights for four coordinates at once
+        const auto x = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(u + i), zero), one), res);
+        const auto y = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(v + i), zero), one), res);
+        const auto col = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(x)), last_cell);
+        const auto row = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(y)), last_cell);
+        const auto fx = _mm_sub_ps(x, col);
+        const auto fy = _mm_sub_ps(y, row);
+        const auto gx = _mm_sub_ps(one, fx);
+        const auto gy = _mm_sub_ps(one, fy);
+
+        alignas(16) int32_t cols[4];
+        alignas(16) int32_t rows[4];
+        alignas(16) float w00[4];
+        alignas(16) float w10[4];
+        alignas(16) float w01[4];
+        alignas(16) float w11[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(cols), _mm_cvttps_epi32(col));
+        _mm_store_si128(reinterpret_cast<__m128i*>(rows), _mm_cvttps_epi32(row));
+        _mm_store_ps(w00, _mm_mul_ps(gx, gy));
+        _mm_store_ps(w10, _mm_mul_ps(fx, gy));
+        _mm_store_ps(w01, _mm_mul_ps(gx, fy));
+        _mm_store_ps(w11, _mm_mul_ps(fx, fy));
+
+        // Blend the red, green, and blue coordinates of each node together
+        for (int j = 0; j < 4; ++j) {
+            const auto base = static_cast<std::size_t>(rows[j]) * stride + static_cast<std::size_t>(cols[j]);
+            const auto n00 = reinterpret_cast<const float*>(&nodes_[base]);
+            const auto n10 = reinterpret_cast<const float*>(&nodes_[base + 1]);
+            const auto n01 = reinterpret_cast<const float*>(&nodes_[base + stride]);
+            const auto n11 = reinterpret_cast<const float*>(&nodes_[base + stride + 1]);
+
+            const auto a = _mm_set1_ps(w00[j]);
+            const auto b = _mm_set1_ps(w10[j]);
+            const auto c = _mm_set1_ps(w01[j]);
+            const auto d = _mm_set1_ps(w11[j]);
+
+            // Red and green
+            auto lo = _mm_mul_ps(a, _mm_loadu_ps(n00));
+            lo = _mm_add_ps(lo, _mm_mul_ps(b, _mm_loadu_ps(n10)));
+            lo = _mm_add_ps(lo, _mm_mul_ps(c, _mm_loadu_ps(n01)));
+            lo = _mm_add_ps(lo, _mm_mul_ps(d, _mm_loadu_ps(n11)));
+
+            // Blue
+            auto hi = _mm_mul_ps(a, _mm_loadl_pi(zero, reinterpret_cast<const __m64*>(n00 + 4)));
+            hi = _mm_add_ps(hi, _mm_mul_ps(b, _mm_loadl_pi(zero, reinterpret_cast<const __m64*>(n10 + 4))));
+            hi = _mm_add_ps(hi, _mm_mul_ps(c, _mm_loadl_pi(zero, reinterpret_cast<const __m64*>(n01 + 4))));
+            hi = _mm_add_ps(hi, _mm_mul_ps(d, _mm_loadl_pi(zero, reinterpret_cast<const __m64*>(n11 + 4))));
+
+            auto out = reinterpret_cast<float*>(&coords[i + j]);
+            _mm_storeu_ps(out, lo);
+            _mm_storel_pi(reinterpret_cast<__m64*>(out + 4), hi);
+        }
+    }
+#endif // OSVR_DISTORTION_GRID_SSE2
+
+    for (; i < count; ++i) {
+        coords[i] = lookup(u[i], v[i]);
+    }
+}
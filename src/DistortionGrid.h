@@ -0,0 +1,105 @@
+/** @file
+    @brief Regular-grid lookup table for distortion coordinates.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_DistortionGrid_h_GUID_6B0C2A4E_93D1_4F7B_8E25_0D4A7C3F1B92
+#define INCLUDED_DistortionGrid_h_GUID_6B0C2A4E_93D1_4F7B_8E25_0D4A7C3F1B92
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+// Standard includes
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief A per-eye table of distortion coordinates sampled on a regular UV
+ * grid.
+ *
+ * The grid is baked once from an exact (and expensive) distortion function
+ * and afterwards answers queries with a bilinear blend of the four
+ * surrounding samples. All three color channels are stored together for each
+ * grid node so that a lookup touches four contiguous records.
+ */
+class DistortionGrid {
+public:
+    using DistortionFunction = std::function<vr::DistortionCoordinates_t(float u, float v)>;
+
+    /**
+     * Samples @p distortion on a (resolution + 1) x (resolution + 1) lattice
+     * covering [0, 1] x [0, 1] in SteamVR texture space.
+     */
+    void bake(std::size_t resolution, const DistortionFunction& distortion);
+
+    /**
+     * Replaces the grid contents with previously baked samples, e.g., those
+     * read back from the distortion cache. @p nodes must hold
+     * (resolution + 1) * (resolution + 1) entries in row-major order.
+     */
+    void assign(std::size_t resolution, const vr::DistortionCoordinates_t* nodes);
+
+    /**
+     * Discards any baked samples.
+     */
+    void clear();
+
+    /**
+     * Returns @c true if the grid has not been baked.
+     */
+    bool empty() const;
+
+    /**
+     * Returns the number of cells along each axis.
+     */
+    std::size_t getResolution() const;
+
+    /**
+     * Returns the baked samples in row-major order.
+     */
+    const std::vector<vr::DistortionCoordinates_t>& getNodes() const;
+
+    /**
+     * Returns the bilinearly interpolated distortion coordinates at (u, v).
+     * Coordinates outside [0, 1] are clamped to the edge of the grid, and NaN
+     * is treated as 0.
+     */
+    vr::DistortionCoordinates_t lookup(float u, float v) const;
+
+    /**
+     * Batch version of lookup() for @p count texture coordinates given as
+     * separate @p u and @p v arrays. Uses SSE2 where available to compute the
+     * cell indices of four coordinates at a time and to blend all three
+     * color channels of a grid node in one pass.
+     */
+    void lookup(const float* u, const float* v, std::size_t count, vr::DistortionCoordinates_t* coords) const;
+
+private:
+    std::size_t resolution_ = 0;
+    std::vector<vr::DistortionCoordinates_t> nodes_;
+};
+
+#endif // INCLUDED_DistortionGrid_h_GUID_6B0C2A4E_93D1_4F7B_8E25_0D4A7C3F1B92
@@ -0,0 +1,66 @@
+/** @file
+    @brief Enumeration of the paths in the OSVR client's path tree.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "InterfacePaths.h"
+
+// Library/third-party includes
+#include <osvr/ClientKit/Context.h>
+#include <osvr/Client/ClientContext.h>
+#include <osvr/Common/PathNode.h>
+#include <osvr/Common/PathTree.h>
+#include <osvr/Util/TreeTraversalVisitor.h>
+
+// Standard includes
+#include <set>
+#include <string>
+
+InterfacePaths getInterfacePaths(osvr::clientkit::ClientContext& context)
+{
+    InterfacePaths paths;
+
+    auto client_context = context.get();
+    if (!client_context)
+        return paths;
+
+    osvr::util::traverseWith(client_context->getPathTree().getRoot(), [&paths](const osvr::common::PathNode& node) {
+        paths.insert(osvr::common::getFullPath(node));
+    });
+
+    return paths;
+}
+
+bool hasPathUnder(const InterfacePaths& paths, const std::string& prefix)
+{
+    if (prefix.empty())
+        return !paths.empty();
+
+    if (paths.count(prefix))
+        return true;
+
+    // Paths below the prefix sort together, right after the prefix itself
+    const auto parent = ('/' == prefix.back()) ? prefix : prefix + "/";
+    const auto it = paths.lower_bound(parent);
+    return it != paths.end() && 0 == it->compare(0, parent.size(), parent);
+}
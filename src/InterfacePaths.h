@@ -0,0 +1,55 @@
+/** @file
+    @brief Enumeration of the paths in the OSVR client's path tree.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_InterfacePaths_h_GUID_4D9B2E17_A8C3_4F6E_B051_7E2A9C6D3F84
+#define INCLUDED_InterfacePaths_h_GUID_4D9B2E17_A8C3_4F6E_B051_7E2A9C6D3F84
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+#include <osvr/ClientKit/Context.h>
+
+// Standard includes
+#include <set>
+#include <string>
+
+/**
+ * Sorted set of full paths, e.g., "/me/hands/left".
+ */
+using InterfacePaths = std::set<std::string>;
+
+/**
+ * Returns the full path of every node in the client context's path tree.
+ * Walking the tree is much cheaper than asking the context for an interface
+ * at each path we might be interested in.
+ */
+InterfacePaths getInterfacePaths(osvr::clientkit::ClientContext& context);
+
+/**
+ * Returns @c true if @p paths contains @p prefix or any path below it.
+ */
+bool hasPathUnder(const InterfacePaths& paths, const std::string& prefix);
+
+#endif // INCLUDED_InterfacePaths_h_GUID_4D9B2E17_A8C3_4F6E_B051_7E2A9C6D3F84
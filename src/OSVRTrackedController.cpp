@@ -24,6 +24,7 @@
 
 // Internal Includes
 #include "OSVRTrackedController.h"
+#include "InterfacePaths.h"
 
 #include "osvr_compiler_detection.h"
 #include "make_unique.h"
@@ -42,12 +43,40 @@
 #include <util/FixedLengthStringFunctions.h>
 
 // Standard includes
+#include <algorithm>        // for std::max
+#include <cmath>            // for std::abs, std::sqrt
 #include <cstring>
 #include <ctime>
 #include <string>
 #include <iostream>
 #include <exception>
 
+namespace {
+
+/**
+ * Zeroes an axis whose distance from the center is within @p deadzone and
+ * rescales the rest of its range so that it still reaches 1.
+ */
+vr::VRControllerAxis_t applyDeadzone(vr::VRControllerAxis_t axis_state, float deadzone)
+{
+    if (deadzone <= 0.0f)
+        return axis_state;
+
+    const auto magnitude = std::sqrt(axis_state.x * axis_state.x + axis_state.y * axis_state.y);
+    if (magnitude <= deadzone || deadzone >= 1.0f) {
+        axis_state.x = 0.0f;
+        axis_state.y = 0.0f;
+        return axis_state;
+    }
+
+    const auto scale = (magnitude - deadzone) / ((1.0f - deadzone) * magnitude);
+    axis_state.x *= scale;
+    axis_state.y *= scale;
+    return axis_state;
+}
+
+} // end anonymous namespace
+
 // TODO:
 // Trackpad
 // OSVRButton(OSVR_BUTTON_TYPE_DIGITAL, FGamepadKeyNames::MotionController_Left_Thumbstick, "/controller/left/joystick/button"),
@@ -62,7 +91,16 @@ OSVRTrackedController::OSVRTrackedController(osvr::clientkit::ClientContext& con
     for (int iter_axis = 0; iter_axis < NUM_AXIS; iter_axis++) {
         analogInterface_[iter_axis].parentController = this;
         analogInterface_[iter_axis].axisType = vr::EVRControllerAxisType::k_eControllerAxis_None;
+        analogInterface_[iter_axis].x = 0.0;
+        analogInterface_[iter_axis].y = 0.0;
     }
+
+    configure();
+
+    axisDeadzone_ = settings_->getSetting<float>("axisDeadzone", axisDeadzone_);
+    axisEpsilon_ = settings_->getSetting<float>("axisEpsilon", axisEpsilon_);
+
+    configurePoseCalibration("driver_osvr_controller" + std::to_string(controller_index));
 }
 
 OSVRTrackedController::~OSVRTrackedController()
@@ -74,23 +112,82 @@ vr::EVRInitError OSVRTrackedController::Activate(uint32_t object_id)
 {
     OSVRTrackedDevice::Activate(object_id);
 
-    const std::time_t wait_time = 5; // wait up to 5 seconds for init
-
+    auto lock = lockContext();
     freeInterfaces();
     numAxis_ = 0;
 
-    // Ensure context is fully started up
-    OSVR_LOG(info) << "Waiting for the context to fully start up...";
-    const auto start_time = std::time(nullptr);
-    while (!context_.checkStatus()) {
-        context_.update();
-        if (std::time(nullptr) > start_time + wait_time) {
-            OSVR_LOG(warn) << "Context startup timed out!";
-            return vr::VRInitError_Driver_Failed;
-        }
+    // Start with nothing pressed, but keep counting packets so that clients
+    // see the change
+    const auto packet_num = controllerState_.unPacketNum;
+    controllerState_ = {};
+    controllerState_.unPacketNum = packet_num;
+    publishControllerState();
+    {
+        std::lock_guard<std::mutex> event_lock(eventMutex_);
+        pendingEvents_.clear();
+    }
+    for (auto& sent_axis_state : sentAxes_) {
+        sent_axis_state = {};
+    }
+
+    // Callbacks are registered by continueActivation() once the context has
+    // started up.
+    return vr::VRInitError_None;
+}
+
+OSVRTrackedDevice::ActivationStatus OSVRTrackedController::continueActivation()
+{
+    // The layout only has to be worked out once; after that re-activation
+    // just opens the interfaces again
+    if (!layoutValid_) {
+        buildLayout();
     }
 
     // Register callbacks
+    if (!layout_.trackerPath.empty()) {
+        trackerInterface_ = context_.getInterface(layout_.trackerPath);
+        trackerInterface_.registerCallback(&OSVRTrackedDevice::trackerCallback<OSVR_PoseReport>, static_cast<OSVRTrackedDevice*>(this));
+    }
+
+    for (const auto& button : layout_.buttons) {
+        buttonInterface_[button.first] = context_.getInterface(button.second);
+        buttonInterface_[button.first].registerCallback(&OSVRTrackedController::controllerButtonCallback, this);
+    }
+
+    // TODO: ADD TOUCHPAD PART HERE
+    numAxis_ = 0;
+
+    for (const auto& axis : layout_.axes) {
+        auto& analog_interface = analogInterface_[axis.axisIndex];
+        analog_interface.axisIndex = axis.axisIndex;
+        analog_interface.axisType = axis.axisType;
+
+        if (vr::EVRControllerAxisType::k_eControllerAxis_Trigger == axis.axisType) {
+            analog_interface.analogInterfaceX = context_.getInterface(axis.xPath);
+            analog_interface.analogInterfaceX.registerCallback(&OSVRTrackedController::controllerTriggerCallback, &analog_interface);
+        } else {
+            if (!axis.xPath.empty()) {
+                analog_interface.analogInterfaceX = context_.getInterface(axis.xPath);
+                analog_interface.analogInterfaceX.registerCallback(&OSVRTrackedController::controllerJoystickXCallback, &analog_interface);
+            }
+            if (!axis.yPath.empty()) {
+                analog_interface.analogInterfaceY = context_.getInterface(axis.yPath);
+                analog_interface.analogInterfaceY.registerCallback(&OSVRTrackedController::controllerJoystickYCallback, &analog_interface);
+            }
+        }
+
+        numAxis_ = std::max(numAxis_, axis.axisIndex + 1);
+    }
+
+    // The axis types are known now
+    configureProperties();
+    driverHost_->TrackedDevicePropertiesChanged(objectId_);
+
+    return ActivationStatus::Succeeded;
+}
+
+void OSVRTrackedController::buildLayout()
+{
     std::string trackerPath;
     std::string buttonPath;
     std::string triggerPath;
@@ -111,96 +208,77 @@ vr::EVRInitError OSVRTrackedController::Activate(uint32_t object_id)
         joystickPath = "/controller" + std::to_string(controllerIndex_) + "/joystick";
     }
 
-    if (!trackerPath.empty()) {
-        trackerInterface_ = context_.getInterface(trackerPath);
-        trackerInterface_.registerCallback(&OSVRTrackedController::controllerTrackerCallback, this);
+    // One walk of the path tree tells us which of the candidate paths exist
+    const auto paths = getInterfacePaths(context_);
+
+    layout_ = ControllerLayout();
+
+    if (!trackerPath.empty() && paths.count(trackerPath)) {
+        layout_.trackerPath = trackerPath;
     }
 
     for (int iter_button = 0; iter_button < NUM_BUTTONS; iter_button++) {
-        buttonInterface_[iter_button] = context_.getInterface(buttonPath + std::to_string(iter_button));
-        if (buttonInterface_[iter_button].notEmpty()) {
-            buttonInterface_[iter_button].registerCallback(&OSVRTrackedController::controllerButtonCallback, this);
-        } else {
-            buttonInterface_[iter_button].free();
+        const auto path = buttonPath + std::to_string(iter_button);
+        if (paths.count(path)) {
+            layout_.buttons.emplace_back(iter_button, path);
         }
     }
 
-    // TODO: ADD TOUCHPAD PART HERE
-    numAxis_ = 0;
-
-    numAxis_ = 1;
-    for (int iter_trigger = 0; iter_trigger < NUM_TRIGGER; iter_trigger++) {
-        if (numAxis_ >= NUM_AXIS)
-            break;
-
-        if (iter_trigger == 0) {
-            analogInterface_[numAxis_].analogInterfaceX = context_.getInterface(triggerPath);
-        } else {
-            analogInterface_[numAxis_].analogInterfaceX = context_.getInterface(triggerPath + std::to_string(iter_trigger));
-        }
-
-        if (analogInterface_[numAxis_].analogInterfaceX.notEmpty()) {
-            analogInterface_[numAxis_].axisIndex = numAxis_;
-            analogInterface_[numAxis_].axisType = vr::EVRControllerAxisType::k_eControllerAxis_Trigger;
-            analogInterface_[numAxis_].analogInterfaceX.registerCallback(&OSVRTrackedController::controllerTriggerCallback, &analogInterface_[numAxis_]);
-            numAxis_++;
-        } else {
-            analogInterface_[numAxis_].analogInterfaceX.free();
-        }
+    // Axis 0 is reserved for the touchpad
+    uint32_t axis_index = 1;
+    for (int iter_trigger = 0; iter_trigger < NUM_TRIGGER && axis_index < NUM_AXIS; iter_trigger++) {
+        const auto path = (iter_trigger == 0) ? triggerPath : triggerPath + std::to_string(iter_trigger);
+        if (!paths.count(path))
+            continue;
+
+        ControllerLayout::Axis axis;
+        axis.axisIndex = axis_index++;
+        axis.axisType = vr::EVRControllerAxisType::k_eControllerAxis_Trigger;
+        axis.xPath = path;
+        layout_.axes.push_back(axis);
     }
 
-    numAxis_ = 2;
-    for (int iter_joystick = 0; iter_joystick < NUM_JOYSTICKS; iter_joystick++) {
-        if (numAxis_ >= NUM_AXIS)
-            break;
-
-        if (iter_joystick == 0) {
-            analogInterface_[numAxis_].analogInterfaceX = context_.getInterface(joystickPath + "/x");
-            analogInterface_[numAxis_].analogInterfaceY = context_.getInterface(joystickPath + "/y");
-        } else {
-            analogInterface_[numAxis_].analogInterfaceX = context_.getInterface(joystickPath + std::to_string(iter_joystick) + "/x");
-            analogInterface_[numAxis_].analogInterfaceY = context_.getInterface(joystickPath + std::to_string(iter_joystick) + "/y");
-        }
-
-        bool somethingFound = false;
-
-        if (analogInterface_[numAxis_].analogInterfaceX.notEmpty()) {
-            analogInterface_[numAxis_].axisIndex = numAxis_;
-            analogInterface_[numAxis_].axisType = vr::EVRControllerAxisType::k_eControllerAxis_Joystick;
-            analogInterface_[numAxis_].analogInterfaceX.registerCallback(&OSVRTrackedController::controllerJoystickXCallback, &analogInterface_[numAxis_]);
-            somethingFound = true;
-        } else {
-            analogInterface_[numAxis_].analogInterfaceX.free();
-        }
-
-        if (analogInterface_[numAxis_].analogInterfaceY.notEmpty()) {
-            analogInterface_[numAxis_].axisIndex = numAxis_;
-            analogInterface_[numAxis_].axisType = vr::EVRControllerAxisType::k_eControllerAxis_Joystick;
-            analogInterface_[numAxis_].analogInterfaceY.registerCallback(&OSVRTrackedController::controllerJoystickYCallback, &analogInterface_[numAxis_]);
-            somethingFound = true;
-        } else {
-            analogInterface_[numAxis_].analogInterfaceY.free();
-        }
-
-        if (somethingFound)
-            numAxis_++;
+    axis_index = 2;
+    for (int iter_joystick = 0; iter_joystick < NUM_JOYSTICKS && axis_index < NUM_AXIS; iter_joystick++) {
+        const auto path = (iter_joystick == 0) ? joystickPath : joystickPath + std::to_string(iter_joystick);
+
+        ControllerLayout::Axis axis;
+        axis.axisType = vr::EVRControllerAxisType::k_eControllerAxis_Joystick;
+        if (paths.count(path + "/x"))
+            axis.xPath = path + "/x";
+        if (paths.count(path + "/y"))
+            axis.yPath = path + "/y";
+        if (axis.xPath.empty() && axis.yPath.empty())
+            continue;
+
+        axis.axisIndex = axis_index++;
+        layout_.axes.push_back(axis);
     }
 
-    return vr::VRInitError_None;
+    // If the controller hasn't shown up yet, look again next time
+    layoutValid_ = !layout_.trackerPath.empty() || !layout_.buttons.empty() || !layout_.axes.empty();
+
+    OSVR_LOG(debug) << "OSVRTrackedController::buildLayout(): " << controllerName_ << " has " << layout_.buttons.size() << " buttons and " << layout_.axes.size() << " axes.";
 }
 
 void OSVRTrackedController::Deactivate()
 {
+    OSVRTrackedDevice::Deactivate();
+
     /// Have to force freeing here
+    auto lock = lockContext();
     freeInterfaces();
 }
 
+void OSVRTrackedController::runFrame(bool context_ready)
+{
+    OSVRTrackedDevice::runFrame(context_ready);
+    flushEvents();
+}
+
 vr::VRControllerState_t OSVRTrackedController::GetControllerState()
 {
-    // TODO
-    vr::VRControllerState_t state;
-    state.unPacketNum = 0;
-    return state;
+    return publishedControllerState_.load();
 }
 
 bool OSVRTrackedController::TriggerHapticPulse(uint32_t axis_id, uint16_t pulse_duration_microseconds)
@@ -227,59 +305,6 @@ void OSVRTrackedController::freeInterfaces()
     }
 }
 
-inline vr::HmdQuaternion_t HmdQuaternion_Init(double w, double x, double y, double z)
-{
-    vr::HmdQuaternion_t quat;
-    quat.w = w;
-    quat.x = x;
-    quat.y = y;
-    quat.z = z;
-    return quat;
-}
-
-void OSVRTrackedController::controllerTrackerCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_PoseReport* report)
-{
-    if (!userdata)
-        return;
-
-    auto* self = static_cast<OSVRTrackedController*>(userdata);
-
-    vr::DriverPose_t pose = { 0 };
-    pose.poseTimeOffset = 0; // close enough
-
-    Eigen::Vector3d::Map(pose.vecWorldFromDriverTranslation) = Eigen::Vector3d::Zero();
-    Eigen::Vector3d::Map(pose.vecDriverFromHeadTranslation) = Eigen::Vector3d::Zero();
-
-    map(pose.qWorldFromDriverRotation) = Eigen::Quaterniond::Identity();
-    map(pose.qDriverFromHeadRotation) = Eigen::Quaterniond::Identity();
-    //pose.qWorldFromDriverRotation = HmdQuaternion_Init(1, 0, 0, 0);
-    //pose.qDriverFromHeadRotation = HmdQuaternion_Init(1, 0, 0, 0);
-
-    // Position
-    Eigen::Vector3d::Map(pose.vecPosition) = osvr::util::vecMap(report->pose.translation);
-
-    // Position velocity and acceleration are not currently consistently provided
-    Eigen::Vector3d::Map(pose.vecVelocity) = Eigen::Vector3d::Zero();
-    Eigen::Vector3d::Map(pose.vecAcceleration) = Eigen::Vector3d::Zero();
-
-    // Orientation
-    map(pose.qRotation) = osvr::util::fromQuat(report->pose.rotation);
-
-    // Angular velocity and acceleration are not currently consistently provided
-    Eigen::Vector3d::Map(pose.vecAngularVelocity) = Eigen::Vector3d::Zero();
-    Eigen::Vector3d::Map(pose.vecAngularAcceleration) = Eigen::Vector3d::Zero();
-
-    pose.result = vr::TrackingResult_Running_OK;
-    pose.poseIsValid = true;
-    //pose.willDriftInYaw = true;
-    //pose.shouldApplyHeadModel = true;
-    pose.deviceIsConnected = true;
-
-    self->pose_ = pose;
-
-    self->driverHost_->TrackedDevicePoseUpdated(self->objectId_, self->pose_);
-}
-
 void OSVRTrackedController::controllerButtonCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_ButtonReport* report)
 {
     if (!userdata)
@@ -296,11 +321,25 @@ void OSVRTrackedController::controllerButtonCallback(void* userdata, const OSVR_
         return;
     }
 
-    if (OSVR_BUTTON_PRESSED == report->state) {
-        self->driverHost_->TrackedDeviceButtonPressed(self->objectId_, button_id, 0);
+    // OSVR doesn't report touches, so a pressed button counts as touched
+    const auto button_mask = vr::ButtonMaskFromId(button_id);
+    const auto pressed = (OSVR_BUTTON_PRESSED == report->state);
+    if (pressed) {
+        self->controllerState_.ulButtonPressed |= button_mask;
+        self->controllerState_.ulButtonTouched |= button_mask;
     } else {
-        self->driverHost_->TrackedDeviceButtonUnpressed(self->objectId_, button_id, 0);
+        self->controllerState_.ulButtonPressed &= ~button_mask;
+        self->controllerState_.ulButtonTouched &= ~button_mask;
     }
+    self->publishControllerState();
+
+    // This may be the client update thread, so SteamVR hears about it on the
+    // next frame
+    ControllerEvent event = {};
+    event.type = pressed ? ControllerEvent::ButtonPressed : ControllerEvent::ButtonUnpressed;
+    event.id = static_cast<uint32_t>(button_id);
+    std::lock_guard<std::mutex> lock(self->eventMutex_);
+    self->pendingEvents_.push_back(event);
 }
 
 void OSVRTrackedController::controllerTriggerCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_AnalogReport* report)
@@ -313,10 +352,7 @@ void OSVRTrackedController::controllerTriggerCallback(void* userdata, const OSVR
 
     analog_interface->x = report->state;
 
-    vr::VRControllerAxis_t axis_state;
-    axis_state.x = static_cast<float>(analog_interface->x);
-
-    self->driverHost_->TrackedDeviceAxisUpdated(self->objectId_, analog_interface->axisIndex, axis_state);
+    self->updateAxis(*analog_interface);
 }
 
 void OSVRTrackedController::controllerJoystickXCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_AnalogReport* report)
@@ -329,11 +365,7 @@ void OSVRTrackedController::controllerJoystickXCallback(void* userdata, const OS
 
     analog_interface->x = report->state;
 
-    vr::VRControllerAxis_t axis_state;
-    axis_state.x = static_cast<float>(analog_interface->x);
-    axis_state.y = static_cast<float>(analog_interface->y);
-
-    self->driverHost_->TrackedDeviceAxisUpdated(self->objectId_, analog_interface->axisIndex, axis_state);
+    self->updateAxis(*analog_interface);
 }
 
 void OSVRTrackedController::controllerJoystickYCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_AnalogReport* report)
@@ -346,11 +378,81 @@ void OSVRTrackedController::controllerJoystickYCallback(void* userdata, const OS
 
     analog_interface->y = report->state;
 
+    self->updateAxis(*analog_interface);
+}
+
+void OSVRTrackedController::updateAxis(const AnalogInterface& analog_interface)
+{
     vr::VRControllerAxis_t axis_state;
-    axis_state.x = static_cast<float>(analog_interface->x);
-    axis_state.y = static_cast<float>(analog_interface->y);
+    axis_state.x = static_cast<float>(analog_interface.x);
+    axis_state.y = static_cast<float>(analog_interface.y);
+
+    axis_state = applyDeadzone(axis_state, axisDeadzone_);
+    controllerState_.rAxis[analog_interface.axisIndex] = axis_state;
+    publishControllerState();
+
+    // SteamVR hears about it on the next frame. Until a button changes only
+    // the newest value of an axis matters, so replace an update that's still
+    // queued rather than adding another.
+    std::lock_guard<std::mutex> lock(eventMutex_);
+    for (auto it = pendingEvents_.rbegin(); it != pendingEvents_.rend() && ControllerEvent::Axis == it->type; ++it) {
+        if (analog_interface.axisIndex == it->id) {
+            it->axisState = axis_state;
+            return;
+        }
+    }
+
+    ControllerEvent event = {};
+    event.type = ControllerEvent::Axis;
+    event.id = analog_interface.axisIndex;
+    event.axisState = axis_state;
+    pendingEvents_.push_back(event);
+}
 
-    self->driverHost_->TrackedDeviceAxisUpdated(self->objectId_, analog_interface->axisIndex, axis_state);
+void OSVRTrackedController::flushEvents()
+{
+    {
+        std::lock_guard<std::mutex> lock(eventMutex_);
+        if (pendingEvents_.empty())
+            return;
+
+        // Keep both buffers' capacity so steady-state frames don't allocate
+        sentEvents_.swap(pendingEvents_);
+    }
+
+    for (const auto& event : sentEvents_) {
+        switch (event.type) {
+        case ControllerEvent::ButtonPressed:
+            driverHost_->TrackedDeviceButtonPressed(objectId_, static_cast<vr::EVRButtonId>(event.id), 0);
+            break;
+        case ControllerEvent::ButtonUnpressed:
+            driverHost_->TrackedDeviceButtonUnpressed(objectId_, static_cast<vr::EVRButtonId>(event.id), 0);
+            break;
+        case ControllerEvent::Axis:
+            sendAxis(event.id, event.axisState);
+            break;
+        }
+    }
+    sentEvents_.clear();
+}
+
+void OSVRTrackedController::sendAxis(uint32_t axis, const vr::VRControllerAxis_t& axis_state)
+{
+    auto& sent_axis_state = sentAxes_[axis];
+    const auto at_rest = (0.0f == axis_state.x && 0.0f == axis_state.y);
+    const auto was_at_rest = (0.0f == sent_axis_state.x && 0.0f == sent_axis_state.y);
+    const auto moved = std::abs(axis_state.x - sent_axis_state.x) > axisEpsilon_ || std::abs(axis_state.y - sent_axis_state.y) > axisEpsilon_;
+    if (!moved && at_rest == was_at_rest)
+        return;
+
+    sent_axis_state = axis_state;
+    driverHost_->TrackedDeviceAxisUpdated(objectId_, axis, axis_state);
+}
+
+void OSVRTrackedController::publishControllerState()
+{
+    ++controllerState_.unPacketNum;
+    publishedControllerState_.store(controllerState_);
 }
 
 const char* OSVRTrackedController::GetId()
@@ -366,18 +468,18 @@ void OSVRTrackedController::configure()
 
 void OSVRTrackedController::configureProperties()
 {
-    properties_[vr::Prop_DeviceClass_Int32] = static_cast<int32_t>(deviceClass_);
-    properties_[vr::Prop_Axis0Type_Int32] = static_cast<int32_t>(analogInterface_[0].axisType);
-    properties_[vr::Prop_Axis1Type_Int32] = static_cast<int32_t>(analogInterface_[1].axisType);
-    properties_[vr::Prop_Axis2Type_Int32] = static_cast<int32_t>(analogInterface_[2].axisType);
-    properties_[vr::Prop_Axis3Type_Int32] = static_cast<int32_t>(analogInterface_[3].axisType);
-    properties_[vr::Prop_Axis4Type_Int32] = static_cast<int32_t>(analogInterface_[4].axisType);
-
-    properties_[vr::Prop_SupportedButtons_Uint64] = static_cast<int32_t>(NUM_BUTTONS);
-
-    properties_[vr::Prop_ModelNumber_String] = "OSVR Controller";
-    properties_[vr::Prop_SerialNumber_String] = controllerName_.c_str();
-    properties_[vr::Prop_RenderModelName_String] = "";
+    properties_.set<vr::Prop_DeviceClass_Int32>(static_cast<int32_t>(deviceClass_));
+    properties_.set<vr::Prop_Axis0Type_Int32>(static_cast<int32_t>(analogInterface_[0].axisType));
+    properties_.set<vr::Prop_Axis1Type_Int32>(static_cast<int32_t>(analogInterface_[1].axisType));
+    properties_.set<vr::Prop_Axis2Type_Int32>(static_cast<int32_t>(analogInterface_[2].axisType));
+    properties_.set<vr::Prop_Axis3Type_Int32>(static_cast<int32_t>(analogInterface_[3].axisType));
+    properties_.set<vr::Prop_Axis4Type_Int32>(static_cast<int32_t>(analogInterface_[4].axisType));
+
+    properties_.set<vr::Prop_SupportedButtons_Uint64>(static_cast<int32_t>(NUM_BUTTONS));
+
+    properties_.set<vr::Prop_ModelNumber_String>("OSVR Controller");
+    properties_.set<vr::Prop_SerialNumber_String>(controllerName_.c_str());
+    properties_.set<vr::Prop_RenderModelName_String>("");
 
     // Properties that are unique to TrackedDeviceClass_Controller
     //Prop_AttachedDeviceId_String				= 3000,
@@ -44,7 +44,10 @@
 #include <osvr/Client/RenderManagerConfig.h>
 
 // Standard includes
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 class OSVRTrackedController;
 
@@ -61,6 +64,23 @@ struct AnalogInterface {
 };
 
 
+/**
+ * The OSVR paths that exist for one controller, found by walking the path
+ * tree once.
+ */
+struct ControllerLayout {
+    struct Axis {
+        uint32_t axisIndex = 0;
+        vr::EVRControllerAxisType axisType = vr::EVRControllerAxisType::k_eControllerAxis_None;
+        std::string xPath;
+        std::string yPath;  ///< empty for triggers
+    };
+
+    std::string trackerPath;
+    std::vector<std::pair<int, std::string>> buttons; ///< button number and path
+    std::vector<Axis> axes;
+};
+
 class OSVRTrackedController : public OSVRTrackedDevice, public vr::IVRControllerComponent {
     friend class ServerDriver_OSVR;
 
@@ -90,12 +110,19 @@ public:
      */
     virtual void Deactivate() OSVR_OVERRIDE;
 
+    /**
+     * Also sends SteamVR the button changes and axes that arrived since the
+     * last frame.
+     */
+    virtual void runFrame(bool context_ready) OSVR_OVERRIDE;
+
     // ------------------------------------
     // Controller Methods
     // ------------------------------------
 
     /**
-     * Gets the current state of a controller.
+     * Gets the current state of a controller. Safe to call from any thread;
+     * never blocks the button and analog callbacks.
      */
     virtual vr::VRControllerState_t GetControllerState() OSVR_OVERRIDE;
 
@@ -107,6 +134,21 @@ public:
 protected:
     const char* GetId();
 
+    /**
+     * Registers the tracker, button, and analog callbacks.
+     */
+    virtual ActivationStatus continueActivation() OSVR_OVERRIDE;
+
+    /**
+     * Callback functions which are called whenever new data has been
+     * received from the controller. The button callback takes the
+     * controller and the analog callbacks its AnalogInterface as userdata.
+     */
+    static void controllerButtonCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_ButtonReport* report);
+    static void controllerTriggerCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_AnalogReport* report);
+    static void controllerJoystickXCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_AnalogReport* report);
+    static void controllerJoystickYCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_AnalogReport* report);
+
 private:
     void configure();
     void configureProperties();
@@ -114,14 +156,33 @@ private:
     void freeInterfaces();
 
     /**
-     * Callback function which is called whenever new data has been received
-     * from the tracker.
+     * Fills in layout_ from the paths that exist in the client's path tree.
      */
-    static void controllerTrackerCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_PoseReport* report);
-    static void controllerButtonCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_ButtonReport* report);
-    static void controllerTriggerCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_AnalogReport* report);
-    static void controllerJoystickXCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_AnalogReport* report);
-    static void controllerJoystickYCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_AnalogReport* report);
+    void buildLayout();
+
+    /**
+     * Stores the new value of an axis in the controller state and queues it
+     * to be sent to SteamVR by the next runFrame().
+     */
+    void updateAxis(const AnalogInterface& analog_interface);
+
+    /**
+     * Sends SteamVR the button changes and axis updates queued by the
+     * callbacks, in the order they arrived.
+     */
+    void flushEvents();
+
+    /**
+     * Sends SteamVR an axis update if the axis moved by more than the axis
+     * epsilon, or came to rest or left it, since it was last sent.
+     */
+    void sendAxis(uint32_t axis, const vr::VRControllerAxis_t& axis_state);
+
+    /**
+     * Bumps the packet number of controllerState_ and makes it visible to
+     * GetControllerState().
+     */
+    void publishControllerState();
 
     std::string controllerName_;
     int controllerIndex_;
@@ -129,6 +190,34 @@ private:
     osvr::clientkit::Interface buttonInterface_[NUM_BUTTONS];
     uint32_t numAxis_;
     AnalogInterface analogInterface_[NUM_AXIS];
+
+    ControllerLayout layout_;
+    bool layoutValid_ = false;
+
+    vr::VRControllerState_t controllerState_ = {};              ///< written by the button and analog callbacks
+    SeqLock<vr::VRControllerState_t> publishedControllerState_; ///< read by GetControllerState()
+
+    struct ControllerEvent {
+        enum Type {
+            ButtonPressed,
+            ButtonUnpressed,
+            Axis
+        };
+
+        Type type;
+        uint32_t id;                        ///< vr::EVRButtonId or axis index
+        vr::VRControllerAxis_t axisState;   ///< for Axis events
+    };
+
+    std::mutex eventMutex_;
+    std::vector<ControllerEvent> pendingEvents_; ///< queued by the callbacks, guarded by eventMutex_
+    std::vector<ControllerEvent> sentEvents_;    ///< being sent by runFrame()
+
+    vr::VRControllerAxis_t sentAxes_[NUM_AXIS] = {}; ///< last values sent to SteamVR
+
+    // Settings
+    float axisDeadzone_ = 0.0f;
+    float axisEpsilon_ = 0.0f;
 };
 
 #endif // INCLUDED_OSVRTrackedDevice_h_GUID_128E3B29_F5FC_4221_9B38_14E3F402E645
@@ -41,6 +41,7 @@
 // Library/third-party includes
 #include <osvr/ClientKit/Display.h>
 #include <osvr/Util/EigenInterop.h>
+#include <osvr/Util/TimeValueC.h>
 #include <osvr/Client/RenderManagerConfig.h>
 #include <util/FixedLengthStringFunctions.h>
 #include <osvr/RenderKit/DistortionCorrectTextureCoordinate.h>
@@ -52,11 +53,77 @@
 #include <iostream>
 #include <exception>
 #include <fstream>
-#include <algorithm>        // for std::find
+#include <algorithm>        // for std::find, std::min
+#include <chrono>
 
-OSVRTrackedDevice::OSVRTrackedDevice(osvr::clientkit::ClientContext& context, vr::IServerDriverHost* driver_host, vr::ETrackedDeviceClass device_class) : context_(context), driverHost_(driver_host), pose_(), deviceClass_(device_class)
+namespace {
+
+// How long a device may take to start up, once the context is up, before we
+// complain about it
+const auto ACTIVATION_TIMEOUT = std::chrono::seconds(5);
+
+// Bounds on the delay between startup attempts
+const auto MIN_ACTIVATION_BACKOFF = std::chrono::milliseconds(10);
+const auto MAX_ACTIVATION_BACKOFF = std::chrono::milliseconds(500);
+
+const double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+
+/**
+ * Reads a calibration transform stored as the settings @p prefix +
+ * TranslationX/Y/Z (meters) and @p prefix + Yaw/Pitch/RollDegrees.
+ *
+ * @return @c true if the transform differs from the identity.
+ */
+bool readCalibrationTransform(Settings& settings, const std::string& prefix, double* translation, vr::HmdQuaternion_t& rotation)
+{
+    const Eigen::Vector3d offset(settings.getSetting<float>(prefix + "TranslationX", 0.0f),
+                                 settings.getSetting<float>(prefix + "TranslationY", 0.0f),
+                                 settings.getSetting<float>(prefix + "TranslationZ", 0.0f));
+    const auto yaw = DEGREES_TO_RADIANS * settings.getSetting<float>(prefix + "YawDegrees", 0.0f);
+    const auto pitch = DEGREES_TO_RADIANS * settings.getSetting<float>(prefix + "PitchDegrees", 0.0f);
+    const auto roll = DEGREES_TO_RADIANS * settings.getSetting<float>(prefix + "RollDegrees", 0.0f);
+
+    // SteamVR is y-up, right-handed, looking down -z
+    const Eigen::Quaterniond orientation = Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitY())
+        * Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitX())
+        * Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitZ());
+
+    Eigen::Vector3d::Map(translation) = offset;
+    map(rotation) = orientation;
+
+    return !offset.isZero() || 0.0 != yaw || 0.0 != pitch || 0.0 != roll;
+}
+
+} // end anonymous namespace
+
+OSVRTrackedDevice::OSVRTrackedDevice(osvr::clientkit::ClientContext& context, vr::IServerDriverHost* driver_host, vr::ETrackedDeviceClass device_class) : context_(context), driverHost_(driver_host), deviceClass_(device_class), activationBackoff_(MIN_ACTIVATION_BACKOFF)
 {
     settings_ = std::make_unique<Settings>(driverHost_->GetSettings(vr::IVRSettings_Version));
+    posePrediction_ = settings_->getSetting<bool>("posePrediction", posePrediction_);
+    poseCoalescing_ = settings_->getSetting<bool>("poseCoalescing", poseCoalescing_);
+    const auto max_pose_update_rate = settings_->getSetting<int32_t>("maxPoseUpdateRateHz", 0);
+    if (max_pose_update_rate > 0) {
+        minPoseUpdateInterval_ = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / max_pose_update_rate;
+    }
+
+    // Everything but the position and orientation of a tracked pose is the
+    // same from one report to the next. Subclasses adjust the flags.
+    poseTemplate_ = {};
+    poseTemplate_.qWorldFromDriverRotation.w = 1.0;
+    poseTemplate_.qDriverFromHeadRotation.w = 1.0;
+    poseTemplate_.qRotation.w = 1.0;
+    poseTemplate_.result = vr::TrackingResult_Running_OK;
+    poseTemplate_.poseIsValid = true;
+    poseTemplate_.willDriftInYaw = false;
+    poseTemplate_.shouldApplyHeadModel = false;
+    poseTemplate_.deviceIsConnected = true;
+
+    // Report the device as not yet tracking until it has started up
+    vr::DriverPose_t pose = poseTemplate_;
+    pose.result = vr::TrackingResult_Uninitialized;
+    pose.poseIsValid = false;
+    pose.deviceIsConnected = false;
+    pose_.store(pose);
 }
 
 OSVRTrackedDevice::~OSVRTrackedDevice()
@@ -67,12 +134,32 @@ OSVRTrackedDevice::~OSVRTrackedDevice()
 vr::EVRInitError OSVRTrackedDevice::Activate(uint32_t object_id)
 {
     objectId_ = object_id;
+
+    // The rest of the startup is driven from runFrame() so that we never
+    // block the server thread waiting on the OSVR server.
+    activationState_ = ActivationState::WaitingForContext;
+    activationBackoff_ = MIN_ACTIVATION_BACKOFF;
+    activationTimeoutReported_ = false;
+
     return vr::VRInitError_None;
 }
 
 void OSVRTrackedDevice::Deactivate()
 {
-    // do nothing
+    activationState_ = ActivationState::Inactive;
+}
+
+void OSVRTrackedDevice::configurePoseCalibration(const std::string& section)
+{
+    Settings settings(driverHost_->GetSettings(vr::IVRSettings_Version), section);
+
+    // Baked into the template so that tracker reports don't pay for it
+    const auto world_from_driver = readCalibrationTransform(settings, "worldFromDriver", poseTemplate_.vecWorldFromDriverTranslation, poseTemplate_.qWorldFromDriverRotation);
+    const auto driver_from_head = readCalibrationTransform(settings, "driverFromHead", poseTemplate_.vecDriverFromHeadTranslation, poseTemplate_.qDriverFromHeadRotation);
+
+    if (world_from_driver || driver_from_head) {
+        OSVR_LOG(info) << "OSVRTrackedDevice::configurePoseCalibration(): Using calibration transforms from [" << section << "].";
+    }
 }
 
 void OSVRTrackedDevice::PowerOff()
@@ -83,7 +170,15 @@ void OSVRTrackedDevice::PowerOff()
 void* OSVRTrackedDevice::GetComponent(const char* component_name_and_version)
 {
     if (!strcasecmp(component_name_and_version, vr::IVRDisplayComponent_Version)) {
-        return dynamic_cast<vr::IVRDisplayComponent*>(this);
+        // SteamVR reads the projection and builds the distortion mesh once,
+        // so don't hand out the display until they're known. Startup runs
+        // from RunFrame(), so SteamVR has to ask again later.
+        const auto display = dynamic_cast<vr::IVRDisplayComponent*>(this);
+        if (display && !isReady()) {
+            OSVR_LOG(info) << "OSVRTrackedDevice::GetComponent(): The display is still starting up.";
+            return nullptr;
+        }
+        return display;
     } else if (!strcasecmp(component_name_and_version, vr::IVRDriverDirectModeComponent_Version)) {
         return dynamic_cast<vr::IVRDriverDirectModeComponent*>(this);
     } else if (!strcasecmp(component_name_and_version, vr::IVRControllerComponent_Version)) {
@@ -102,15 +197,86 @@ void OSVRTrackedDevice::DebugRequest(const char* request, char* response_buffer,
     OSVR_LOG(debug) << "Received debug request [" << request << "] with response buffer size of " << response_buffer_size << "].";
 
     // make use of (from vrtypes.h) static const uint32_t k_unMaxDriverDebugResponseSize = 32768;
-    // return empty string for now
-    if (response_buffer_size > 0) {
+    std::string response;
+    if (!strcasecmp(request, "pose_stats")) {
+        response = "received=" + std::to_string(posesReceived_.load())
+            + " published=" + std::to_string(posesPublished_.load())
+            + " dropped=" + std::to_string(posesDropped_.load());
+    } else if (!strcasecmp(request, "property_stats")) {
+        response = "hits=" + std::to_string(properties_.getHits())
+            + " recomputes=" + std::to_string(properties_.getRecomputes());
+    }
+
+    if (0 == valveStrCpy(response, response_buffer, response_buffer_size) && response_buffer_size > 0) {
         response_buffer[0] = '\0';
     }
 }
 
 vr::DriverPose_t OSVRTrackedDevice::GetPose()
 {
-    return pose_;
+    return pose_.load();
+}
+
+void OSVRTrackedDevice::runFrame(bool context_ready)
+{
+    // Deliver the newest pose queued by the client update thread, by pose
+    // coalescing, or by the maximum pose update rate
+    if (isQueuingPoses()) {
+        flushPose(Clock::now());
+    }
+
+    advanceActivation(context_ready);
+}
+
+void OSVRTrackedDevice::advanceActivation(bool context_ready)
+{
+    // The context is shared by all devices, so ServerDriver_OSVR waits on it
+    // once for all of them.
+    if (ActivationState::WaitingForContext == activationState_) {
+        if (!context_ready)
+            return;
+
+        const auto start = Clock::now();
+        activationState_ = ActivationState::WaitingForDevice;
+        activationDeadline_ = start + ACTIVATION_TIMEOUT;
+        nextActivationAttempt_ = start;
+    }
+
+    if (ActivationState::WaitingForDevice != activationState_)
+        return;
+
+    const auto now = Clock::now();
+    if (now < nextActivationAttempt_)
+        return;
+
+    const auto status = [this] {
+        auto lock = lockContext();
+        return continueActivation();
+    }();
+    if (ActivationStatus::Succeeded == status) {
+        OSVR_LOG(info) << "OSVRTrackedDevice::advanceActivation(): Device " << objectId_ << " activated.";
+        activationState_ = ActivationState::Active;
+        return;
+    } else if (ActivationStatus::Failed == status) {
+        OSVR_LOG(err) << "OSVRTrackedDevice::advanceActivation(): Device " << objectId_ << " failed to activate.";
+        activationState_ = ActivationState::Failed;
+        return;
+    }
+
+    // Keep retrying past the deadline in case the device shows up late, but
+    // let the user know something is wrong.
+    if (!activationTimeoutReported_ && now > activationDeadline_) {
+        OSVR_LOG(warn) << "OSVRTrackedDevice::advanceActivation(): Device " << objectId_ << ": Device startup timed out! Still waiting...";
+        activationTimeoutReported_ = true;
+    }
+
+    nextActivationAttempt_ = now + activationBackoff_;
+    activationBackoff_ = std::min<Clock::duration>(activationBackoff_ * 2, MAX_ACTIVATION_BACKOFF);
+}
+
+bool OSVRTrackedDevice::isReady() const
+{
+    return ActivationState::Active == activationState_;
 }
 
 bool OSVRTrackedDevice::GetBoolTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* error)
@@ -143,34 +309,108 @@ vr::HmdMatrix34_t OSVRTrackedDevice::GetMatrix34TrackedDeviceProperty(vr::ETrack
 
 uint32_t OSVRTrackedDevice::GetStringTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, char* value, uint32_t buffer_size, vr::ETrackedPropertyError *error)
 {
-    uint32_t default_value = 0;
-
-    const auto result = checkProperty(prop, value);
-    if (vr::TrackedProp_Success != result) {
+    vr::ETrackedPropertyError result;
+    const auto str = findTrackedDeviceProperty<std::string>(prop, &result);
+    if (!str) {
         if (error)
             *error = result;
-        return default_value;
+        return 0;
     }
 
-    const auto str = GetStringTrackedDeviceProperty(prop, error);
-    if (*error == vr::TrackedProp_Success) {
-        if (str.size() + 1 > buffer_size) {
-            *error = vr::TrackedProp_BufferTooSmall;
-        } else {
-            valveStrCpy(str, value, buffer_size);
-        }
-        return static_cast<uint32_t>(str.size()) + 1;
+    // A size probe (buffer_size == 0) only needs the length
+    const auto size = static_cast<uint32_t>(str->size()) + 1;
+    if (size > buffer_size) {
+        result = vr::TrackedProp_BufferTooSmall;
+    } else {
+        valveStrCpy(*str, value, buffer_size);
     }
 
-    return 0;
+    if (error)
+        *error = result;
+    return size;
 }
 
 // ------------------------------------
 // Protected Methods
 // ------------------------------------
 
-std::string OSVRTrackedDevice::GetStringTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *error)
+OSVRTrackedDevice::ActivationStatus OSVRTrackedDevice::continueActivation()
+{
+    return ActivationStatus::Succeeded;
+}
+
+void OSVRTrackedDevice::publishPose(const OSVR_TimeValue& timestamp, vr::DriverPose_t pose)
+{
+    if (posePrediction_) {
+        posePredictor_.update(timestamp, pose);
+    }
+
+    ++posesReceived_;
+
+    const TimestampedPose timestamped_pose = { timestamp, pose };
+    if (isQueuingPoses()) {
+        if (poseBuffer_.write(timestamped_pose)) {
+            ++posesDropped_;
+        }
+        return;
+    }
+
+    updatePose(timestamped_pose);
+}
+
+bool OSVRTrackedDevice::isQueuingPoses() const
+{
+    // Poses that arrive too soon wait in the queue rather than being
+    // dropped, so the newest one still reaches SteamVR once it's due
+    const auto rate_limited = (minPoseUpdateInterval_ > Clock::duration::zero());
+    return queuePoses_ || poseCoalescing_ || rate_limited;
+}
+
+void OSVRTrackedDevice::flushPose(Clock::time_point now)
+{
+    // Leave the pose queued until it's due; newer reports will replace it in
+    // the meantime
+    if (now - lastPoseUpdate_ < minPoseUpdateInterval_)
+        return;
+
+    TimestampedPose pose;
+    if (!poseBuffer_.read(pose))
+        return;
+
+    lastPoseUpdate_ = now;
+    updatePose(pose);
+}
+
+void OSVRTrackedDevice::updatePose(const TimestampedPose& timestamped_pose)
+{
+    auto pose = timestamped_pose.pose;
+
+    // Tell SteamVR how old the report is so it can extrapolate the pose to
+    // the present
+    if (posePrediction_) {
+        OSVR_TimeValue now;
+        osvrTimeValueGetNow(&now);
+        pose.poseTimeOffset = std::min(osvrTimeValueDurationSeconds(&timestamped_pose.timestamp, &now), 0.0);
+    }
+
+    pose_.store(pose);
+    driverHost_->TrackedDevicePoseUpdated(objectId_, pose);
+    ++posesPublished_;
+}
+
+void OSVRTrackedDevice::invalidateProperty(vr::ETrackedDeviceProperty prop)
 {
-    return GetTrackedDeviceProperty(prop, error, std::string{""});
+    properties_.invalidate(prop);
+    if (isReady()) {
+        driverHost_->TrackedDevicePropertiesChanged(objectId_);
+    }
+}
+
+std::unique_lock<std::mutex> OSVRTrackedDevice::lockContext()
+{
+    if (!contextMutex_)
+        return std::unique_lock<std::mutex>();
+
+    return std::unique_lock<std::mutex>(*contextMutex_);
 }
 
@@ -29,8 +29,12 @@
 #include "osvr_compiler_detection.h"    // for OSVR_OVERRIDE
 #include "Settings.h"
 #include "display/Display.h"
-#include "PropertyMap.h"
+#include "PropertyStore.h"
 #include "PropertyProperties.h"
+#include "PoseConversion.h"
+#include "PosePredictor.h"
+#include "SeqLock.h"
+#include "TripleBuffer.h"
 
 // OpenVR includes
 #include <openvr_driver.h>
@@ -47,6 +51,9 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 
 class OSVRTrackedDevice : public vr::ITrackedDeviceServerDriver {
 friend class ServerDriver_OSVR;
@@ -101,6 +108,25 @@ public:
 
     virtual vr::DriverPose_t GetPose() OSVR_OVERRIDE;
 
+    // ------------------------------------
+    // Startup Methods
+    // ------------------------------------
+
+    /**
+     * Advances the device's startup. Called once per frame by
+     * ServerDriver_OSVR::RunFrame() after the client context has been
+     * updated.
+     *
+     * @param context_ready @c true once the shared client context has fully
+     *     started up.
+     */
+    virtual void runFrame(bool context_ready);
+
+    /**
+     * Returns @c true once the device has finished activating.
+     */
+    bool isReady() const;
+
     // ------------------------------------
     // Property Methods
     // ------------------------------------
@@ -147,11 +173,71 @@ public:
     virtual uint32_t GetStringTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, char* value, uint32_t buffer_size, vr::ETrackedPropertyError* error) OSVR_OVERRIDE;
 
 protected:
-    std::string GetStringTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *error);
+    enum class ActivationState {
+        Inactive,           ///< Activate() has not been called
+        WaitingForContext,  ///< waiting for ServerDriver_OSVR to report the context is up
+        WaitingForDevice,   ///< waiting on continueActivation()
+        Active,             ///< fully started up
+        Failed              ///< startup failed and will not be retried
+    };
+
+    enum class ActivationStatus {
+        Pending,
+        Succeeded,
+        Failed
+    };
+
+    /**
+     * Performs the device-specific part of activation once the client context
+     * has started up. Called from runFrame(), with a backoff, until it returns
+     * something other than ActivationStatus::Pending. Must not block.
+     */
+    virtual ActivationStatus continueActivation();
+
+    /**
+     * Hands a new pose, reported at @p timestamp, to SteamVR. Fills in the
+     * pose's velocities and accelerations from the recent history and its
+     * time offset from the report's age. When the client context is updated
+     * on its own thread, or when pose coalescing is enabled, the pose is
+     * queued and only the newest queued pose is delivered by the next
+     * runFrame().
+     */
+    void publishPose(const OSVR_TimeValue& timestamp, vr::DriverPose_t pose);
+
+    /**
+     * Callback function which is called whenever new data has been received
+     * from a tracker. Register it with the device (as an
+     * OSVRTrackedDevice*) as userdata.
+     *
+     * @tparam Report OSVR_PoseReport, OSVR_PositionReport, or
+     *     OSVR_OrientationReport
+     */
+    template <typename Report>
+    static void trackerCallback(void* userdata, const OSVR_TimeValue* timestamp, const Report* report);
+
+    /**
+     * Reads the world-from-driver and driver-from-head calibration transforms
+     * from the settings @p section into the pose template. Call from
+     * configure(), before any tracker callbacks are registered.
+     */
+    void configurePoseCalibration(const std::string& section);
+
+    /**
+     * Marks a provided property as out of date and, once the device is
+     * active, tells SteamVR to read its properties again.
+     */
+    void invalidateProperty(vr::ETrackedDeviceProperty prop);
+
+    /**
+     * Locks the client context if it is being updated on its own thread.
+     * Hold the lock while using context_ or any of its interfaces outside of
+     * a callback.
+     */
+    std::unique_lock<std::mutex> lockContext();
 
     /**
      * Cecks to see if the requested property is valid for the device class and
-     * type requested.
+     * type requested, using a single lookup in the property table.
      *
      * @tparam T type of value requested
      * @param prop property requested
@@ -160,53 +246,139 @@ protected:
      * vr::ETrackedPropertyError values on failure
      */
     template <typename T>
-    vr::ETrackedPropertyError checkProperty(vr::ETrackedDeviceProperty prop, const T&);
+    vr::ETrackedPropertyError checkProperty(vr::ETrackedDeviceProperty prop);
+
+    /**
+     * Looks up a property without copying it.
+     *
+     * @return a pointer to the stored value, valid until the property is next
+     * set, or @c nullptr with @p error set if it can't be returned
+     */
+    template <typename T>
+    const T* findTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* error);
 
     template <typename T>
     T GetTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* error, const T& default_value);
 
     osvr::clientkit::ClientContext& context_;
     vr::IServerDriverHost* driverHost_ = nullptr;
-    vr::DriverPose_t pose_;
+    SeqLock<vr::DriverPose_t> pose_; ///< written by the tracker callbacks, read by GetPose()
+    vr::DriverPose_t poseTemplate_;  ///< fields of pose_ that tracker reports don't change
     vr::ETrackedDeviceClass deviceClass_;
     std::unique_ptr<Settings> settings_;
     uint32_t objectId_ = 0;
 
     /** \name Collections of properties and their values. */
     //@{
-    PropertyMap properties_;
+    PropertyStore properties_;
+    //@}
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    ActivationState activationState_ = ActivationState::Inactive;
+    Clock::time_point activationDeadline_;
+    Clock::time_point nextActivationAttempt_;
+    Clock::duration activationBackoff_;
+    bool activationTimeoutReported_ = false;
+
+    /**
+     * Makes the next startup attempt if it's due.
+     */
+    void advanceActivation(bool context_ready);
+
+    /** \name Set by ServerDriver_OSVR when it runs the client update thread. */
+    //@{
+    std::mutex* contextMutex_ = nullptr;
+    bool queuePoses_ = false;
+    //@}
+
+    struct TimestampedPose {
+        OSVR_TimeValue timestamp;
+        vr::DriverPose_t pose;
+    };
+
+    /**
+     * Stores @p pose and sends it to SteamVR with its time offset relative
+     * to now.
+     */
+    void updatePose(const TimestampedPose& pose);
+
+    /**
+     * Returns @c true if poses are queued for runFrame() rather than sent to
+     * SteamVR as they arrive. A maximum pose update rate queues them too, so
+     * it applies whether or not coalescing or the client update thread is on.
+     */
+    bool isQueuingPoses() const;
+
+    /**
+     * Hands the newest queued pose to SteamVR, unless that would exceed the
+     * maximum pose update rate.
+     */
+    void flushPose(Clock::time_point now);
+
+    TripleBuffer<TimestampedPose> poseBuffer_;
+    PosePredictor posePredictor_;
+    bool posePrediction_ = false;
+
+    /** \name Pose coalescing */
+    //@{
+    bool poseCoalescing_ = false;
+    Clock::duration minPoseUpdateInterval_ = Clock::duration::zero();
+    Clock::time_point lastPoseUpdate_;
+    //@}
+
+    /** \name Pose update counters, reported by the "pose_stats" debug request. */
+    //@{
+    std::atomic<uint64_t> posesReceived_ { 0 };
+    std::atomic<uint64_t> posesPublished_ { 0 };
+    std::atomic<uint64_t> posesDropped_ { 0 }; ///< replaced by a newer pose before being published
     //@}
 };
 
+template <typename Report>
+inline void OSVRTrackedDevice::trackerCallback(void* userdata, const OSVR_TimeValue* timestamp, const Report* report)
+{
+    if (!userdata)
+        return;
+
+    auto* self = static_cast<OSVRTrackedDevice*>(userdata);
+    self->publishPose(*timestamp, convertPose(self->poseTemplate_, *report));
+}
+
 template <typename T>
-inline T OSVRTrackedDevice::GetTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* error, const T& default_value)
+inline const T* OSVRTrackedDevice::findTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* error)
 {
-    const auto result = checkProperty(prop, T());
+    const auto result = checkProperty<T>(prop);
     if (vr::TrackedProp_Success != result) {
         if (error)
             *error = result;
-        return default_value;
+        return nullptr;
     }
 
-    if (properties_.find(prop) != end(properties_)) {
-        if (error)
-            *error = vr::TrackedProp_Success;
-        return boost::get<T>(properties_[prop]);
-    } else {
-        if (error)
-            *error = vr::TrackedProp_ValueNotProvidedByDevice;
-        return default_value;
-    }
+    const auto value = properties_.get<T>(prop);
+    if (error)
+        *error = value ? vr::TrackedProp_Success : vr::TrackedProp_ValueNotProvidedByDevice;
+    return value;
 }
 
 template <typename T>
-inline vr::ETrackedPropertyError OSVRTrackedDevice::checkProperty(vr::ETrackedDeviceProperty prop, const T&)
+inline T OSVRTrackedDevice::GetTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* error, const T& default_value)
 {
-    if (isWrongDataType(prop, T())) {
+    const auto value = findTrackedDeviceProperty<T>(prop, error);
+    return value ? *value : default_value;
+}
+
+template <typename T>
+inline vr::ETrackedPropertyError OSVRTrackedDevice::checkProperty(vr::ETrackedDeviceProperty prop)
+{
+    const auto info = getPropertyInfo(prop);
+
+    if (isWrongDataType(info, PropertyTypeOf<T>::value)) {
         return vr::TrackedProp_WrongDataType;
     }
 
-    if (isWrongDeviceClass(prop, deviceClass_)) {
+    if (isWrongDeviceClass(info, deviceClass_)) {
         return vr::TrackedProp_WrongDeviceClass;
     }
 
@@ -33,7 +33,9 @@
 #include "platform_fixes.h" // strcasecmp
 #include "make_unique.h"
 #include "osvr_platform.h"
+#include "display/DisplayCache.h"
 #include "display/DisplayEnumerator.h"
+#include "display/DisplayHotplugMonitor.h"
 
 // OpenVR includes
 #include <openvr_driver.h>
@@ -51,14 +53,36 @@
 #include <string>
 #include <iostream>
 #include <exception>
-#include <algorithm>        // for std::find
+#include <algorithm>        // for std::min, std::max
+#include <chrono>
+#include <cmath>            // for std::ceil, std::sqrt
+#include <future>
+#include <utility>          // for std::move
 
-OSVRTrackedHMD::OSVRTrackedHMD(osvr::clientkit::ClientContext& context, vr::IServerDriverHost* driver_host) : OSVRTrackedDevice(context, driver_host, vr::TrackedDeviceClass_HMD)
+namespace {
+
+// Number of triangles RenderManager uses for each eye's distortion mesh.
+const int DISTORTION_MESH_TRIANGLES = 200 * 64;
+
+// SteamVR asks for the distortion of both eyes.
+const size_t NUM_EYES = 2;
+
+} // end anonymous namespace
+
+OSVRTrackedHMD::OSVRTrackedHMD(osvr::clientkit::ClientContext& context, vr::IServerDriverHost* driver_host, const std::string& user_driver_config_dir) : OSVRTrackedDevice(context, driver_host, vr::TrackedDeviceClass_HMD), userDriverConfigDir_(user_driver_config_dir)
 {
     OSVR_LOG(trace) << "OSVRTrackedHMD::OSVRTrackedHMD() called.";
 
     settings_ = std::make_unique<Settings>(driver_host->GetSettings(vr::IVRSettings_Version));
     configure();
+
+    // Enumerating displays is slow, so only do it when asked and after
+    // displays change
+    properties_.setProvider<vr::Prop_IsOnDesktop_Bool>([this] { return detectDisplayOnDesktop(); });
+
+    // The head tracker is IMU-based and reports the center of the head
+    poseTemplate_.willDriftInYaw = true;
+    poseTemplate_.shouldApplyHeadModel = true;
 }
 
 OSVRTrackedHMD::~OSVRTrackedHMD()
@@ -72,78 +96,17 @@ vr::EVRInitError OSVRTrackedHMD::Activate(uint32_t object_id)
 
     OSVRTrackedDevice::Activate(object_id);
 
-    const std::time_t waitTime = 5; // wait up to 5 seconds for init
+    auto lock = lockContext();
 
     // Register tracker callback
     if (trackerInterface_.notEmpty()) {
         trackerInterface_.free();
     }
 
-    // Ensure context is fully started up
-    OSVR_LOG(trace) << "OSVRTrackedHMD::Activate(): Waiting for the context to fully start up...\n";
-    std::time_t startTime = std::time(nullptr);
-    while (!context_.checkStatus()) {
-        context_.update();
-        if (std::time(nullptr) > startTime + waitTime) {
-            OSVR_LOG(err) << "OSVRTrackedHMD::Activate(): Context startup timed out!\n";
-            return vr::VRInitError_Driver_Failed;
-        }
-    }
-
-    configureDistortionParameters();
-
-    displayConfig_ = osvr::clientkit::DisplayConfig(context_);
-
-    // Ensure display is fully started up
-    OSVR_LOG(trace) << "OSVRTrackedHMD::Activate(): Waiting for the display to fully start up, including receiving initial pose update...\n";
-    startTime = std::time(nullptr);
-    while (!displayConfig_.checkStartup()) {
-        context_.update();
-        if (std::time(nullptr) > startTime + waitTime) {
-            OSVR_LOG(err) << "OSVRTrackedHMD::Activate(): Display startup timed out!\n";
-            return vr::VRInitError_Driver_Failed;
-        }
-    }
-
-    // Verify valid display config
-    if ((displayConfig_.getNumViewers() != 1) && (displayConfig_.getViewer(0).getNumEyes() != 2) && (displayConfig_.getViewer(0).getEye(0).getNumSurfaces() == 1) && (displayConfig_.getViewer(0).getEye(1).getNumSurfaces() != 1)) {
-        OSVR_LOG(err) << "OSVRTrackedHMD::Activate(): Unexpected display parameters!\n";
-
-        if (displayConfig_.getNumViewers() < 1) {
-            OSVR_LOG(err) << "OSVRTrackedHMD::Activate(): At least one viewer must exist.\n";
-            return vr::VRInitError_Driver_HmdDisplayNotFound;
-        } else if (displayConfig_.getViewer(0).getNumEyes() < 2) {
-            OSVR_LOG(err) << "OSVRTrackedHMD::Activate(): At least two eyes must exist.\n";
-            return vr::VRInitError_Driver_HmdDisplayNotFound;
-        } else if ((displayConfig_.getViewer(0).getEye(0).getNumSurfaces() < 1) || (displayConfig_.getViewer(0).getEye(1).getNumSurfaces() < 1)) {
-            OSVR_LOG(err) << "OSVRTrackedHMD::Activate(): At least one surface must exist for each eye.\n";
-            return vr::VRInitError_Driver_HmdDisplayNotFound;
-        }
-    }
+    // The display config is created by continueActivation() once the context
+    // has started up.
+    displayConfig_ = osvr::clientkit::DisplayConfig();
 
-    // Register tracker callback
-    trackerInterface_ = context_.getInterface("/me/head");
-    trackerInterface_.registerCallback(&OSVRTrackedHMD::HmdTrackerCallback, this);
-
-    auto configString = context_.getStringParameter("/renderManagerConfig");
-
-    // If the /renderManagerConfig parameter is missing from the configuration
-    // file, use an empty dictionary instead. This allows the render manager
-    // config to zero out its values.
-    if (configString.empty()) {
-        OSVR_LOG(info) << "OSVRTrackedHMD::Activate(): Render Manager config is empty, using default values.\n";
-        configString = "{}";
-    }
-
-    try {
-        renderManagerConfig_.parse(configString);
-    } catch(const std::exception& e) {
-        OSVR_LOG(err) << "OSVRTrackedHMD::Activate(): Exception parsing Render Manager config: " << e.what() << "\n";
-    }
-
-    driverHost_->ProximitySensorState(objectId_, true);
-
-    OSVR_LOG(trace) << "OSVRTrackedHMD::Activate(): Activation complete.\n";
     return vr::VRInitError_None;
 }
 
@@ -151,23 +114,37 @@ void OSVRTrackedHMD::Deactivate()
 {
     OSVR_LOG(trace) << "OSVRTrackedHMD::Deactivate() called.";
 
+    OSVRTrackedDevice::Deactivate();
+
+    // Don't leave the distortion workers running if we're deactivated
+    // mid-startup
+    waitForDistortionParameters();
+
     /// Have to force freeing here
+    auto lock = lockContext();
     if (trackerInterface_.notEmpty()) {
         trackerInterface_.free();
     }
 }
 
-void OSVRTrackedHMD::GetWindowBounds(int32_t* x, int32_t* y, uint32_t* width, uint32_t* height)
+void OSVRTrackedHMD::runFrame(bool context_ready)
 {
-    int nDisplays = displayConfig_.getNumDisplayInputs();
-    if (nDisplays != 1) {
-        OSVR_LOG(err) << "OSVRTrackedHMD::OSVRTrackedHMD(): Unexpected display number of displays!\n";
+    OSVRTrackedDevice::runFrame(context_ready);
+
+    // The cache has already been refreshed, so only the property needs to be
+    // recomputed
+    if (displayCache_->poll()) {
+        OSVR_LOG(debug) << "OSVRTrackedHMD::runFrame(): Displays changed (" << to_string(displayCache_->getLastRefresh()) << ").";
+        invalidateProperty(vr::Prop_IsOnDesktop_Bool);
     }
-    osvr::clientkit::DisplayDimensions displayDims = displayConfig_.getDisplayDimensions(0);
+}
+
+void OSVRTrackedHMD::GetWindowBounds(int32_t* x, int32_t* y, uint32_t* width, uint32_t* height)
+{
     *x = renderManagerConfig_.getWindowXPosition(); // todo: assumes desktop display of 1920. get this from display config when it's exposed.
     *y = renderManagerConfig_.getWindowYPosition();
-    *width = static_cast<uint32_t>(displayDims.width);
-    *height = static_cast<uint32_t>(displayDims.height);
+    *width = static_cast<uint32_t>(displayDimensions_.width);
+    *height = static_cast<uint32_t>(displayDimensions_.height);
 
 #if defined(OSVR_WINDOWS) || defined(OSVR_MACOSX)
     // ... until we've added code for other platforms
@@ -180,14 +157,27 @@ void OSVRTrackedHMD::GetWindowBounds(int32_t* x, int32_t* y, uint32_t* width, ui
 
 bool OSVRTrackedHMD::IsDisplayOnDesktop()
 {
-    // If the current display still appeara in the active displays list,
-    // then it's attached to the desktop.
-    const auto displays = osvr::display::getDisplays();
-    const auto display_on_desktop = (end(displays) != std::find(begin(displays), end(displays), display_));
-    OSVR_LOG(trace) << "OSVRTrackedHMD::IsDisplayOnDesktop(): " << (display_on_desktop ? "yes" : "no");
+    const auto on_desktop = properties_.get<bool>(vr::Prop_IsOnDesktop_Bool);
+    return on_desktop && *on_desktop;
+}
+
+bool OSVRTrackedHMD::detectDisplayOnDesktop()
+{
+    // Look the display up by identity; display_ holds its desktop state from
+    // when it was first detected.
+    const auto displays = displayCache_->getDisplays();
+    const auto display_on_desktop = osvr::display::isAttachedToDesktop(*displays, display_);
+    OSVR_LOG(trace) << "OSVRTrackedHMD::detectDisplayOnDesktop(): " << (display_on_desktop ? "yes" : "no");
     return display_on_desktop;
 }
 
+void OSVRTrackedHMD::displaysChanged()
+{
+    displayCache_->invalidate();
+    invalidateProperty(vr::Prop_IsOnDesktop_Bool);
+    invalidateProperty(vr::Prop_UserIpdMeters_Float);
+}
+
 bool OSVRTrackedHMD::IsDisplayRealDisplay()
 {
     // TODO get this info from display description?
@@ -208,7 +198,7 @@ void OSVRTrackedHMD::GetRecommendedRenderTargetSize(uint32_t* width, uint32_t* h
 
 void OSVRTrackedHMD::GetEyeOutputViewport(vr::EVREye eye, uint32_t* x, uint32_t* y, uint32_t* width, uint32_t* height)
 {
-    osvr::clientkit::RelativeViewport viewPort = displayConfig_.getViewer(0).getEye(eye).getSurface(0).getRelativeViewport();
+    const auto& viewPort = eyeViewports_[static_cast<size_t>(eye)];
     *x = static_cast<uint32_t>(viewPort.left);
     *y = static_cast<uint32_t>(viewPort.bottom);
     *width = static_cast<uint32_t>(viewPort.width);
@@ -219,7 +209,7 @@ void OSVRTrackedHMD::GetProjectionRaw(vr::EVREye eye, float* left, float* right,
 {
     // Reference: https://github.com/ValveSoftware/openvr/wiki/IVRSystem::GetProjectionRaw
     // SteamVR expects top and bottom to be swapped!
-    osvr::clientkit::ProjectionClippingPlanes pl = displayConfig_.getViewer(0).getEye(eye).getSurface(0).getProjectionClippingPlanes();
+    const auto& pl = eyeProjections_[static_cast<size_t>(eye)];
     *left = static_cast<float>(pl.left);
     *right = static_cast<float>(pl.right);
     *bottom = static_cast<float>(pl.top); // SWAPPED
@@ -228,17 +218,105 @@ void OSVRTrackedHMD::GetProjectionRaw(vr::EVREye eye, float* left, float* right,
 
 vr::DistortionCoordinates_t OSVRTrackedHMD::ComputeDistortion(vr::EVREye eye, float u, float v)
 {
-    // Note that RenderManager expects the (0, 0) to be the lower-left corner and (1, 1) to be the upper-right corner while SteamVR assumes (0, 0) is upper-left and (1, 1) is lower-right.
-    // To accommodate this, we need to flip the y-coordinate before passing it to RenderManager and flip it again before returning the value to SteamVR.
     OSVR_LOG(trace) << "OSVRTrackedHMD::ComputeDistortion(" << eye << ", " << u << ", " << v << ") called.";
 
+    vr::DistortionCoordinates_t coords;
+    computeDistortion(eye, &u, &v, 1, &coords);
+    return coords;
+}
+
+void OSVRTrackedHMD::computeDistortion(vr::EVREye eye, const float* u, const float* v, size_t count, vr::DistortionCoordinates_t* coords)
+{
+    const auto osvr_eye = static_cast<size_t>(eye);
+    if (!exactDistortion_ && osvr_eye < distortionGrids_.size() && !distortionGrids_[osvr_eye].empty()) {
+        distortionGrids_[osvr_eye].lookup(u, v, count, coords);
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        coords[i] = computeExactDistortion(eye, u[i], v[i]);
+    }
+}
+
+OSVRTrackedDevice::ActivationStatus OSVRTrackedHMD::continueActivation()
+{
+    if (!displayConfig_.valid()) {
+        displayConfig_ = osvr::clientkit::DisplayConfig(context_);
+        if (!displayConfig_.valid())
+            return ActivationStatus::Pending;
+
+        // Starts building the distortion mesh in the background while we wait
+        // for the display
+        configureDistortionParameters();
+    }
+
+    // Ensure display is fully started up
+    if (!displayConfig_.checkStartup()) {
+        OSVR_LOG(trace) << "OSVRTrackedHMD::continueActivation(): Waiting for the display to fully start up, including receiving initial pose update...\n";
+        return ActivationStatus::Pending;
+    }
+
+    // Verify valid display config
+    if ((displayConfig_.getNumViewers() != 1) && (displayConfig_.getViewer(0).getNumEyes() != 2) && (displayConfig_.getViewer(0).getEye(0).getNumSurfaces() == 1) && (displayConfig_.getViewer(0).getEye(1).getNumSurfaces() != 1)) {
+        OSVR_LOG(err) << "OSVRTrackedHMD::continueActivation(): Unexpected display parameters!\n";
+        waitForDistortionParameters();
+
+        if (displayConfig_.getNumViewers() < 1) {
+            OSVR_LOG(err) << "OSVRTrackedHMD::continueActivation(): At least one viewer must exist.\n";
+            return ActivationStatus::Failed;
+        } else if (displayConfig_.getViewer(0).getNumEyes() < 2) {
+            OSVR_LOG(err) << "OSVRTrackedHMD::continueActivation(): At least two eyes must exist.\n";
+            return ActivationStatus::Failed;
+        } else if ((displayConfig_.getViewer(0).getEye(0).getNumSurfaces() < 1) || (displayConfig_.getViewer(0).getEye(1).getNumSurfaces() < 1)) {
+            OSVR_LOG(err) << "OSVRTrackedHMD::continueActivation(): At least one surface must exist for each eye.\n";
+            return ActivationStatus::Failed;
+        }
+    }
+
+    // Register tracker callback
+    trackerInterface_ = context_.getInterface("/me/head");
+    trackerInterface_.registerCallback(&OSVRTrackedDevice::trackerCallback<OSVR_PoseReport>, static_cast<OSVRTrackedDevice*>(this));
+
+    auto configString = context_.getStringParameter("/renderManagerConfig");
+
+    // If the /renderManagerConfig parameter is missing from the configuration
+    // file, use an empty dictionary instead. This allows the render manager
+    // config to zero out its values.
+    if (configString.empty()) {
+        OSVR_LOG(info) << "OSVRTrackedHMD::continueActivation(): Render Manager config is empty, using default values.\n";
+        configString = "{}";
+    }
+
+    try {
+        renderManagerConfig_.parse(configString);
+    } catch(const std::exception& e) {
+        OSVR_LOG(err) << "OSVRTrackedHMD::continueActivation(): Exception parsing Render Manager config: " << e.what() << "\n";
+    }
+
+    waitForDistortionParameters();
+    captureDisplayConfig();
+
+    // Now that the display is up, let SteamVR know about its properties
+    configureProperties();
+    driverHost_->TrackedDevicePropertiesChanged(objectId_);
+
+    driverHost_->ProximitySensorState(objectId_, true);
+
+    OSVR_LOG(trace) << "OSVRTrackedHMD::continueActivation(): Activation complete.\n";
+    return ActivationStatus::Succeeded;
+}
+
+vr::DistortionCoordinates_t OSVRTrackedHMD::computeExactDistortion(vr::EVREye eye, float u, float v)
+{
+    // Note that RenderManager expects the (0, 0) to be the lower-left corner and (1, 1) to be the upper-right corner while SteamVR assumes (0, 0) is upper-left and (1, 1) is lower-right.
+    // To accommodate this, we need to flip the y-coordinate before passing it to RenderManager and flip it again before returning the value to SteamVR.
     using osvr::renderkit::DistortionCorrectTextureCoordinate;
     static const size_t COLOR_RED = 0;
     static const size_t COLOR_GREEN = 1;
     static const size_t COLOR_BLUE = 2;
 
     const auto osvr_eye = static_cast<size_t>(eye);
-    const auto distortion_parameters = distortionParameters_[osvr_eye];
+    const auto& distortion_parameters = distortionParameters_[osvr_eye];
     const auto in_coords = osvr::renderkit::Float2 {{u, 1.0f - v}}; // flip v-coordinate
 
     auto interpolators = &leftEyeInterpolators_;
@@ -270,48 +348,32 @@ vr::DistortionCoordinates_t OSVRTrackedHMD::ComputeDistortion(vr::EVREye eye, fl
     return coords;
 }
 
-void OSVRTrackedHMD::HmdTrackerCallback(void* userdata, const OSVR_TimeValue*, const OSVR_PoseReport* report)
+void OSVRTrackedHMD::captureDisplayConfig()
 {
-    if (!userdata)
-        return;
-
-    auto* self = static_cast<OSVRTrackedHMD*>(userdata);
-
-    vr::DriverPose_t pose;
-    pose.poseTimeOffset = 0; // close enough
-
-    Eigen::Vector3d::Map(pose.vecWorldFromDriverTranslation) = Eigen::Vector3d::Zero();
-    Eigen::Vector3d::Map(pose.vecDriverFromHeadTranslation) = Eigen::Vector3d::Zero();
-
-    map(pose.qWorldFromDriverRotation) = Eigen::Quaterniond::Identity();
-
-    map(pose.qDriverFromHeadRotation) = Eigen::Quaterniond::Identity();
-
-    // Position
-    Eigen::Vector3d::Map(pose.vecPosition) = osvr::util::vecMap(report->pose.translation);
-
-    // Position velocity and acceleration are not currently consistently provided
-    Eigen::Vector3d::Map(pose.vecVelocity) = Eigen::Vector3d::Zero();
-    Eigen::Vector3d::Map(pose.vecAcceleration) = Eigen::Vector3d::Zero();
-
-    // Orientation
-    map(pose.qRotation) = osvr::util::fromQuat(report->pose.rotation);
-
-    // Angular velocity and acceleration are not currently consistently provided
-    Eigen::Vector3d::Map(pose.vecAngularVelocity) = Eigen::Vector3d::Zero();
-    Eigen::Vector3d::Map(pose.vecAngularAcceleration) = Eigen::Vector3d::Zero();
-
-    pose.result = vr::TrackingResult_Running_OK;
-    pose.poseIsValid = true;
-    pose.willDriftInYaw = true;
-    pose.shouldApplyHeadModel = true;
+    if (displayConfig_.getNumDisplayInputs() != 1) {
+        OSVR_LOG(err) << "OSVRTrackedHMD::captureDisplayConfig(): Unexpected display number of displays!\n";
+    }
+    displayDimensions_ = displayConfig_.getDisplayDimensions(0);
 
-    self->pose_ = pose;
-    self->driverHost_->TrackedDevicePoseUpdated(self->objectId_, self->pose_);
+    for (uint8_t eye = 0; eye < 2; ++eye) {
+        const auto surface = displayConfig_.getViewer(0).getEye(eye).getSurface(0);
+        eyeViewports_[eye] = surface.getRelativeViewport();
+        eyeProjections_[eye] = surface.getProjectionClippingPlanes();
+    }
 }
 
 float OSVRTrackedHMD::GetIPD()
 {
+    // Runs when SteamVR reads the property, which may be while the client
+    // update thread is using the context
+    auto lock = lockContext();
+    if (!displayConfig_.valid()) {
+        // Re-activating; configureProperties() has the IPD measured again once
+        // the display config is back
+        OSVR_LOG(warn) << "OSVRTrackedHMD::GetIPD(): The display config isn't available yet.";
+        return 0.0f;
+    }
+
     OSVR_Pose3 leftEye, rightEye;
 
     if (displayConfig_.getViewer(0).getEye(0).getPose(leftEye) != true) {
@@ -331,10 +393,39 @@ void OSVRTrackedHMD::configure()
     // The name of the display we want to use
     const std::string display_name = settings_->getSetting<std::string>("displayName", "OSVR");
 
+    configurePoseCalibration("driver_osvr_hmd");
+
+    // Distortion lookup grid
+    distortionGridResolution_ = settings_->getSetting<int32_t>("distortionGridResolution", distortionGridResolution_);
+    exactDistortion_ = settings_->getSetting<bool>("exactDistortion", exactDistortion_);
+
+    // Baked distortion grids are cached in the user's driver config directory
+    const auto cache_distortion = settings_->getSetting<bool>("cacheDistortion", true);
+    if (cache_distortion && !userDriverConfigDir_.empty()) {
+        distortionCache_ = std::make_unique<DistortionCache>(userDriverConfigDir_ + OSVR_PATH_SEPARATOR + "distortion_cache.bin");
+    }
+
+    // Panel latency model for Prop_SecondsFromVsyncToPhotons_Float. The
+    // default suits panels that light up once the whole frame is scanned
+    // out (e.g., low-persistence OLEDs).
+    panelLatencySeconds_ = std::max(settings_->getSetting<float>("panelLatencySeconds", panelLatencySeconds_), 0.0f);
+    panelScanoutFraction_ = std::max(settings_->getSetting<float>("panelScanoutFraction", panelScanoutFraction_), 0.0f);
+
+    // Enumerating displays can be slow, so the results are kept until a
+    // display is connected or disconnected, or they expire. A negative
+    // timeout only expires them where there are no hotplug notifications.
+    auto display_monitor = osvr::display::makeDisplayHotplugMonitor();
+    auto display_cache_timeout = settings_->getSetting<float>("displayCacheTimeoutSeconds", -1.0f);
+    if (display_cache_timeout < 0.0f) {
+        display_cache_timeout = display_monitor ? 0.0f : 5.0f;
+    }
+    const auto display_cache_ttl = std::chrono::duration_cast<osvr::display::DisplayCache::Clock::duration>(std::chrono::duration<float>(display_cache_timeout));
+    displayCache_ = std::make_unique<osvr::display::DisplayCache>(display_cache_ttl, &osvr::display::getDisplays, std::move(display_monitor));
+
     // Detect displays and find the one we're using as an HMD
     bool display_found = false;
-    auto displays = osvr::display::getDisplays();
-    for (const auto& display : displays) {
+    const auto displays = displayCache_->getDisplays();
+    for (const auto& display : *displays) {
         if (std::string::npos == display.name.find(display_name))
             continue;
 
@@ -352,12 +443,19 @@ void OSVRTrackedHMD::configure()
         display_.position.x = 1920;
         display_.position.y = 0;
         display_.rotation = osvr::display::Rotation::Zero;
-        display_.verticalRefreshRate = 60.0;
+        display_.verticalRefreshRate = {148500000, 2200 * 1125}; // CEA-861 1080p60 timing
         display_.attachedToDesktop = true;
         display_.edidVendorId = 0xd24e;// 53838
         display_.edidProductId = 0x1019; // 4121
     }
 
+    // Windows may report 0/0 and an EDID timing with zero totals gives
+    // pixelClock/0; SteamVR needs a real frequency to time frames.
+    if (0.0 == display_.verticalRefreshRate.hertz()) {
+        OSVR_LOG(warn) << "OSVRTrackedHMD::configure(): Unknown refresh rate (" << display_.verticalRefreshRate.numerator << "/" << display_.verticalRefreshRate.denominator << "), assuming 60 Hz.";
+        display_.verticalRefreshRate = {60, 1};
+    }
+
     if (display_found) {
         OSVR_LOG(info) << "Detected display named [" << display_.name << "]:";
     } else {
@@ -384,7 +482,7 @@ void OSVRTrackedHMD::configure()
         OSVR_LOG(info) << "  Rotation: Landscape";
         break;
     }
-    OSVR_LOG(info) << "  Refresh rate: " << display_.verticalRefreshRate;
+    OSVR_LOG(info) << "  Refresh rate: " << display_.verticalRefreshRate.hertz() << " Hz (" << display_.verticalRefreshRate.numerator << "/" << display_.verticalRefreshRate.denominator << ")";
     OSVR_LOG(info) << "  " << (display_.attachedToDesktop ? "Extended mode" : "Direct mode");
     OSVR_LOG(info) << "  EDID vendor ID: " << display_.edidVendorId;
     OSVR_LOG(info) << "  EDID product ID: " << display_.edidProductId;
@@ -392,117 +490,233 @@ void OSVRTrackedHMD::configure()
 
 void OSVRTrackedHMD::configureDistortionParameters()
 {
-    // Parse the display descriptor
     displayDescription_ = context_.getStringParameter("/display");
+
+    // A cache hit means the grids for this display descriptor have already
+    // been baked, so parsing the descriptor and building the mesh
+    // interpolators can be skipped entirely.
+    if (loadDistortionGrids()) {
+        OSVR_LOG(info) << "OSVRTrackedHMD::configureDistortionParameters(): Loaded distortion grids from cache.";
+        return;
+    }
+
+    // Parse the display descriptor
     displayConfiguration_ = OSVRDisplayConfiguration(displayDescription_);
 
     // Initialize the distortion parameters
+    distortionParameters_.clear();
     OSVR_LOG(debug) << "OSVRTrackedHMD::configureDistortionParameters(): Number of eyes: " << displayConfiguration_.getEyes().size() << ".";
     for (size_t i = 0; i < displayConfiguration_.getEyes().size(); ++i) {
         auto distortion = osvr::renderkit::DistortionParameters { displayConfiguration_, i };
-        distortion.m_desiredTriangles = 200 * 64;
+        distortion.m_desiredTriangles = DISTORTION_MESH_TRIANGLES;
         OSVR_LOG(debug) << "OSVRTrackedHMD::configureDistortionParameters(): Adding distortion for eye " << i << ".";
         distortionParameters_.push_back(distortion);
     }
     OSVR_LOG(debug) << "OSVRTrackedHMD::configureDistortionParameters(): Number of distortion parameters: " << distortionParameters_.size() << ".";
 
-    // Make the interpolators to be used by each eye.
-    OSVR_LOG(debug) << "OSVRTrackedHMD::configureDistortionParameters(): Creating mesh interpolators for the left eye.";
-    if (!makeUnstructuredMeshInterpolators(distortionParameters_[0], 0, leftEyeInterpolators_)) {
-        OSVR_LOG(err) << "OSVRTrackedHMD::configureDistortionParameters(): Could not create mesh interpolators for left eye.";
+    // Build the interpolators and bake the grid for each eye on its own
+    // worker thread. Each worker only touches its own eye's interpolators and
+    // grid. continueActivation() joins them before the HMD is ready.
+    const auto num_eyes = std::min<size_t>(distortionParameters_.size(), 2);
+    distortionGrids_.clear();
+    if (0 == getDistortionGridResolution()) {
+        OSVR_LOG(info) << "OSVRTrackedHMD::configureDistortionParameters(): Distortion grid disabled, using exact distortion.";
+    } else {
+        distortionGrids_.resize(num_eyes);
     }
-    OSVR_LOG(debug) << "OSVRTrackedHMD::configureDistortionParameters(): Number of left eye interpolators: " << leftEyeInterpolators_.size() << ".";
 
-    OSVR_LOG(debug) << "OSVRTrackedHMD::configureDistortionParameters(): Creating mesh interpolators for the right eye.";
-    if (!makeUnstructuredMeshInterpolators(distortionParameters_[1], 1, rightEyeInterpolators_)) {
-        OSVR_LOG(err) << "OSVRTrackedHMD::configureDistortionParameters(): Could not create mesh interpolators for right eye.";
+    for (size_t i = 0; i < num_eyes; ++i) {
+        distortionTasks_.push_back(std::async(std::launch::async, &OSVRTrackedHMD::configureEyeDistortion, this, i));
     }
-    OSVR_LOG(debug) << "OSVRTrackedHMD::configureDistortionParameters(): Number of right eye interpolators: " << leftEyeInterpolators_.size() << ".";
+}
+
+void OSVRTrackedHMD::configureEyeDistortion(size_t eye)
+{
+    const auto eye_name = (0 == eye) ? "left" : "right";
+    auto& interpolators = (0 == eye) ? leftEyeInterpolators_ : rightEyeInterpolators_;
+
+    OSVR_LOG(debug) << "OSVRTrackedHMD::configureEyeDistortion(): Creating mesh interpolators for the " << eye_name << " eye.";
+    if (!makeUnstructuredMeshInterpolators(distortionParameters_[eye], eye, interpolators)) {
+        OSVR_LOG(err) << "OSVRTrackedHMD::configureEyeDistortion(): Could not create mesh interpolators for " << eye_name << " eye.";
+    }
+    OSVR_LOG(debug) << "OSVRTrackedHMD::configureEyeDistortion(): Number of " << eye_name << " eye interpolators: " << interpolators.size() << ".";
+
+    if (eye >= distortionGrids_.size())
+        return;
+
+    const auto resolution = getDistortionGridResolution();
+    const auto vr_eye = static_cast<vr::EVREye>(eye);
+    OSVR_LOG(debug) << "OSVRTrackedHMD::configureEyeDistortion(): Baking " << resolution << "x" << resolution << " distortion grid for the " << eye_name << " eye.";
+    distortionGrids_[eye].bake(resolution, [this, vr_eye](float u, float v) {
+        return computeExactDistortion(vr_eye, u, v);
+    });
+}
+
+void OSVRTrackedHMD::waitForDistortionParameters()
+{
+    if (distortionTasks_.empty())
+        return;
+
+    bool succeeded = true;
+    for (auto& task : distortionTasks_) {
+        try {
+            task.get();
+        } catch (const std::exception& e) {
+            OSVR_LOG(err) << "OSVRTrackedHMD::waitForDistortionParameters(): Exception configuring distortion: " << e.what();
+            succeeded = false;
+        }
+    }
+    distortionTasks_.clear();
+
+    if (!succeeded) {
+        // Fall back to the exact distortion rather than serving a partially
+        // baked grid
+        distortionGrids_.clear();
+        return;
+    }
+
+    saveDistortionGrids();
+}
+
+bool OSVRTrackedHMD::loadDistortionGrids()
+{
+    const auto resolution = getDistortionGridResolution();
+    if (!distortionCache_ || 0 == resolution)
+        return false;
+
+    const auto key = DistortionCache::makeKey(displayDescription_, overfillFactor_, resolution);
+    if (!distortionCache_->load(key, resolution, distortionGrids_))
+        return false;
+
+    // A cache hit skips building the distortion parameters the exact
+    // distortion falls back on, so there must be a grid for every eye.
+    const auto num_eyes = (displayConfig_.getNumViewers() < 1) ? 0 : static_cast<size_t>(displayConfig_.getViewer(0).getNumEyes());
+    if (NUM_EYES != distortionGrids_.size() || num_eyes != distortionGrids_.size()) {
+        OSVR_LOG(warn) << "OSVRTrackedHMD::loadDistortionGrids(): Ignoring cached distortion grids for " << distortionGrids_.size() << " eyes; the display has " << num_eyes << ".";
+        distortionGrids_.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void OSVRTrackedHMD::saveDistortionGrids()
+{
+    if (!distortionCache_ || distortionGrids_.empty())
+        return;
+
+    const auto resolution = distortionGrids_.front().getResolution();
+    const auto key = DistortionCache::makeKey(displayDescription_, overfillFactor_, resolution);
+    if (!distortionCache_->save(key, distortionGrids_)) {
+        OSVR_LOG(warn) << "OSVRTrackedHMD::saveDistortionGrids(): Could not write the distortion cache.";
+    }
+}
+
+size_t OSVRTrackedHMD::getDistortionGridResolution() const
+{
+    if (exactDistortion_ || distortionGridResolution_ < 0)
+        return 0;
+
+    if (distortionGridResolution_ > 0)
+        return static_cast<size_t>(distortionGridResolution_);
+
+    // The mesh is a regular triangulation, so a grid with one cell per pair of
+    // triangles samples the distortion about as finely as the mesh resolves
+    // it.
+    return static_cast<size_t>(std::ceil(std::sqrt(DISTORTION_MESH_TRIANGLES / 2.0)));
 }
 
 void OSVRTrackedHMD::configureProperties()
 {
     // General properties that apply to all device classes
 
-    properties_[vr::Prop_WillDriftInYaw_Bool] = true;
-    properties_[vr::Prop_DeviceIsWireless_Bool] = false;
-    properties_[vr::Prop_DeviceIsCharging_Bool] = false;
-    properties_[vr::Prop_Firmware_UpdateAvailable_Bool] = false;
-    properties_[vr::Prop_Firmware_ManualUpdate_Bool] = false;
-    properties_[vr::Prop_BlockServerShutdown_Bool] = false;
-    //properties_[vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool] = true;
-    properties_[vr::Prop_ContainsProximitySensor_Bool] = false;
-    properties_[vr::Prop_DeviceProvidesBatteryStatus_Bool] = false;
-    properties_[vr::Prop_DeviceCanPowerOff_Bool] = true;
-    properties_[vr::Prop_HasCamera_Bool] = false;
-
-    properties_[vr::Prop_DeviceBatteryPercentage_Float] = 1.0f; // full battery
-
-    properties_[vr::Prop_DeviceClass_Int32] = deviceClass_;
-
-    //properties_[vr::Prop_HardwareRevision_Uint64] = 0ul;
-    //properties_[vr::Prop_FirmwareVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_FPGAVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_VRCVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_RadioVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_DongleVersion_Uint64] = 0ul;
-
-    //properties_[vr::Prop_StatusDisplayTransform_Matrix34] = /* TODO */
-
-    //properties_[vr::Prop_TrackingSystemName_String] = "";
-    properties_[vr::Prop_ModelNumber_String] = "OSVR HMD";
-    properties_[vr::Prop_SerialNumber_String] = display_.name;
-    //properties_[vr::Prop_RenderModelName_String] = "";
-    //properties_[vr::Prop_ManufacturerName_String] = "";
-    //properties_[vr::Prop_TrackingFirmwareVersion_String] = "";
-    //properties_[vr::Prop_HardwareRevision_String] = "";
-    //properties_[vr::Prop_AllWirelessDongleDescriptions_String] = "";
-    //properties_[vr::Prop_ConnectedWirelessDongle_String] = "";
-    //properties_[vr::Prop_Firmware_ManualUpdateURL_String] = "";
-    //properties_[vr::Prop_Firmware_ProgrammingTarget_String] = "";
-    //properties_[vr::Prop_DriverVersion_String] = "";
+    properties_.set<vr::Prop_WillDriftInYaw_Bool>(true);
+    properties_.set<vr::Prop_DeviceIsWireless_Bool>(false);
+    properties_.set<vr::Prop_DeviceIsCharging_Bool>(false);
+    properties_.set<vr::Prop_Firmware_UpdateAvailable_Bool>(false);
+    properties_.set<vr::Prop_Firmware_ManualUpdate_Bool>(false);
+    properties_.set<vr::Prop_BlockServerShutdown_Bool>(false);
+    //properties_.set<vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool>(true);
+    properties_.set<vr::Prop_ContainsProximitySensor_Bool>(false);
+    properties_.set<vr::Prop_DeviceProvidesBatteryStatus_Bool>(false);
+    properties_.set<vr::Prop_DeviceCanPowerOff_Bool>(true);
+    properties_.set<vr::Prop_HasCamera_Bool>(false);
+
+    properties_.set<vr::Prop_DeviceBatteryPercentage_Float>(1.0f); // full battery
+
+    properties_.set<vr::Prop_DeviceClass_Int32>(deviceClass_);
+
+    //properties_.set<vr::Prop_HardwareRevision_Uint64>(0ul);
+    //properties_.set<vr::Prop_FirmwareVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_FPGAVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_VRCVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_RadioVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_DongleVersion_Uint64>(0ul);
+
+    //properties_.set<vr::Prop_StatusDisplayTransform_Matrix34>(/* TODO */);
+
+    //properties_.set<vr::Prop_TrackingSystemName_String>("");
+    properties_.set<vr::Prop_ModelNumber_String>("OSVR HMD");
+    properties_.set<vr::Prop_SerialNumber_String>(display_.name);
+    //properties_.set<vr::Prop_RenderModelName_String>("");
+    //properties_.set<vr::Prop_ManufacturerName_String>("");
+    //properties_.set<vr::Prop_TrackingFirmwareVersion_String>("");
+    //properties_.set<vr::Prop_HardwareRevision_String>("");
+    //properties_.set<vr::Prop_AllWirelessDongleDescriptions_String>("");
+    //properties_.set<vr::Prop_ConnectedWirelessDongle_String>("");
+    //properties_.set<vr::Prop_Firmware_ManualUpdateURL_String>("");
+    //properties_.set<vr::Prop_Firmware_ProgrammingTarget_String>("");
+    //properties_.set<vr::Prop_DriverVersion_String>("");
 
 
     // Properties that apply to HMDs
 
-    //properties_[vr::Prop_ReportsTimeSinceVSync_Bool] = false;
-    properties_[vr::Prop_IsOnDesktop_Bool] = IsDisplayOnDesktop();
-
-    //properties_[vr::Prop_SecondsFromVsyncToPhotons_Float] = 0.0;
-    properties_[vr::Prop_DisplayFrequency_Float] = static_cast<float>(display_.verticalRefreshRate);
-    properties_[vr::Prop_UserIpdMeters_Float] = GetIPD();
-    //properties_[vr::Prop_DisplayMCOffset_Float] = 0.0;
-    //properties_[vr::Prop_DisplayMCScale_Float] = 0.0;
-    //properties_[vr::Prop_DisplayGCBlackClamp_Float] = 0.0;
-    //properties_[vr::Prop_DisplayGCOffset_Float] = 0.0;
-    //properties_[vr::Prop_DisplayGCScale_Float] = 0.0;
-    //properties_[vr::Prop_DisplayGCPrescale_Float] = 0.0;
-    //properties_[vr::Prop_LensCenterLeftU_Float] = 0.0;
-    //properties_[vr::Prop_LensCenterLeftV_Float] = 0.0;
-    //properties_[vr::Prop_LensCenterRightU_Float] = 0.0;
-    //properties_[vr::Prop_LensCenterRightV_Float] = 0.0;
-    //properties_[vr::Prop_UserHeadToEyeDepthMeters_Float] = 0.0;
-
-    //properties_[vr::Prop_DisplayMCType_Int32] = 0;
-    properties_[vr::Prop_EdidVendorID_Int32] = static_cast<int32_t>(display_.edidVendorId);
-    properties_[vr::Prop_EdidProductID_Int32] = static_cast<int32_t>(display_.edidProductId);
-    //properties_[vr::Prop_DisplayGCType_Int32] = 0;
-    //properties_[vr::Prop_CameraCompatibilityMode_Int32] = 0;
-
-    properties_[vr::Prop_CurrentUniverseId_Uint64] = 1;
-    properties_[vr::Prop_PreviousUniverseId_Uint64] = 1;
-    properties_[vr::Prop_DisplayFirmwareVersion_Uint64] = 192; // FIXME read from OSVR server
-    //properties_[vr::Prop_CameraFirmwareVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_DisplayFPGAVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_DisplayBootloaderVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_DisplayHardwareVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_AudioFirmwareVersion_Uint64] = 0ul;
-
-    //properties_[vr::Prop_CameraToHeadTransform_Matrix34] = /* TODO */
-
-    //properties_[vr::Prop_DisplayMCImageLeft_String] = "";
-    //properties_[vr::Prop_DisplayMCImageRight_String] = "";
-    //properties_[vr::Prop_DisplayGCImage_String] = "";
-    //properties_[vr::Prop_CameraFirmwareDescription_String] = "";
+    //properties_.set<vr::Prop_ReportsTimeSinceVSync_Bool>(false);
+    // Prop_IsOnDesktop_Bool is provided since construction
+
+    properties_.set<vr::Prop_SecondsFromVsyncToPhotons_Float>(getSecondsFromVsyncToPhotons());
+    properties_.set<vr::Prop_DisplayFrequency_Float>(static_cast<float>(display_.verticalRefreshRate.hertz()));
+    // OSVR doesn't report IPD changes, so the IPD is measured on first read
+    // and again after each new display config or displaysChanged()
+    properties_.setProvider<vr::Prop_UserIpdMeters_Float>([this] { return GetIPD(); });
+    //properties_.set<vr::Prop_DisplayMCOffset_Float>(0.0);
+    //properties_.set<vr::Prop_DisplayMCScale_Float>(0.0);
+    //properties_.set<vr::Prop_DisplayGCBlackClamp_Float>(0.0);
+    //properties_.set<vr::Prop_DisplayGCOffset_Float>(0.0);
+    //properties_.set<vr::Prop_DisplayGCScale_Float>(0.0);
+    //properties_.set<vr::Prop_DisplayGCPrescale_Float>(0.0);
+    //properties_.set<vr::Prop_LensCenterLeftU_Float>(0.0);
+    //properties_.set<vr::Prop_LensCenterLeftV_Float>(0.0);
+    //properties_.set<vr::Prop_LensCenterRightU_Float>(0.0);
+    //properties_.set<vr::Prop_LensCenterRightV_Float>(0.0);
+    //properties_.set<vr::Prop_UserHeadToEyeDepthMeters_Float>(0.0);
+
+    //properties_.set<vr::Prop_DisplayMCType_Int32>(0);
+    properties_.set<vr::Prop_EdidVendorID_Int32>(static_cast<int32_t>(display_.edidVendorId));
+    properties_.set<vr::Prop_EdidProductID_Int32>(static_cast<int32_t>(display_.edidProductId));
+    //properties_.set<vr::Prop_DisplayGCType_Int32>(0);
+    //properties_.set<vr::Prop_CameraCompatibilityMode_Int32>(0);
+
+    properties_.set<vr::Prop_CurrentUniverseId_Uint64>(1ul);
+    properties_.set<vr::Prop_PreviousUniverseId_Uint64>(1ul);
+    properties_.set<vr::Prop_DisplayFirmwareVersion_Uint64>(192); // FIXME read from OSVR server
+    //properties_.set<vr::Prop_CameraFirmwareVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_DisplayFPGAVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_DisplayBootloaderVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_DisplayHardwareVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_AudioFirmwareVersion_Uint64>(0ul);
+
+    //properties_.set<vr::Prop_CameraToHeadTransform_Matrix34>(/* TODO */);
+
+    //properties_.set<vr::Prop_DisplayMCImageLeft_String>("");
+    //properties_.set<vr::Prop_DisplayMCImageRight_String>("");
+    //properties_.set<vr::Prop_DisplayGCImage_String>("");
+    //properties_.set<vr::Prop_CameraFirmwareDescription_String>("");
+}
+
+float OSVRTrackedHMD::getSecondsFromVsyncToPhotons() const
+{
+    const auto frame_period = display_.verticalRefreshRate.period();
+    return static_cast<float>(panelLatencySeconds_ + panelScanoutFraction_ * frame_period);
 }
 
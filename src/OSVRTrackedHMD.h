@@ -27,7 +27,10 @@
 
 // Internal Includes
 #include "OSVRTrackedDevice.h"
+#include "DistortionCache.h"
+#include "DistortionGrid.h"
 #include "display/Display.h"
+#include "display/DisplayCache.h"
 
 // Library/third-party includes
 #include <openvr_driver.h>
@@ -39,14 +42,16 @@
 #include <osvr/RenderKit/osvr_display_configuration.h>
 
 // Standard includes
+#include <array>
 #include <string>
 #include <memory>
 #include <vector>
+#include <future>
 
 class OSVRTrackedHMD : public OSVRTrackedDevice, public vr::IVRDisplayComponent {
 friend class ServerDriver_OSVR;
 public:
-    OSVRTrackedHMD(osvr::clientkit::ClientContext& context, vr::IServerDriverHost* driver_host);
+    OSVRTrackedHMD(osvr::clientkit::ClientContext& context, vr::IServerDriverHost* driver_host, const std::string& user_driver_config_dir);
 
     virtual ~OSVRTrackedHMD();
 
@@ -57,6 +62,11 @@ public:
     virtual vr::EVRInitError Activate(uint32_t object_id) OSVR_OVERRIDE;
     virtual void Deactivate() OSVR_OVERRIDE;
 
+    /**
+     * Also checks for displays being connected or disconnected.
+     */
+    virtual void runFrame(bool context_ready) OSVR_OVERRIDE;
+
     // ------------------------------------
     // Display Methods
     // ------------------------------------
@@ -67,7 +77,8 @@ public:
     virtual void GetWindowBounds(int32_t* x, int32_t* y, uint32_t* width, uint32_t* height) OSVR_OVERRIDE;
 
     /**
-     * Returns true if the display is extending the desktop.
+     * Returns true if the display is extending the desktop. The answer is
+     * cached until displaysChanged() is called.
      */
     virtual bool IsDisplayOnDesktop() OSVR_OVERRIDE;
 
@@ -101,13 +112,48 @@ public:
      */
     virtual vr::DistortionCoordinates_t ComputeDistortion(vr::EVREye eye, float u, float v) OSVR_OVERRIDE;
 
+    /**
+     * Batch version of ComputeDistortion() for @p count UVs of one eye, for
+     * use by mesh generation and offline tools. Results are written to the
+     * contiguous @p coords array.
+     */
+    void computeDistortion(vr::EVREye eye, const float* u, const float* v, size_t count, vr::DistortionCoordinates_t* coords);
+
+    /**
+     * Call when displays may have been connected or disconnected so that the
+     * display-dependent properties are checked again.
+     */
+    void displaysChanged();
+
+protected:
+    /**
+     * Creates the display config and waits for the display to start up.
+     */
+    virtual ActivationStatus continueActivation() OSVR_OVERRIDE;
+
 private:
     /**
-     * Callback function which is called whenever new data has been received
-     * from the tracker.
+     * Evaluates the distortion function against the mesh interpolators
+     * without consulting the distortion grid.
+     */
+    vr::DistortionCoordinates_t computeExactDistortion(vr::EVREye eye, float u, float v);
+
+    /**
+     * Enumerates the displays to see whether ours is extending the desktop.
+     * Provides Prop_IsOnDesktop_Bool.
      */
-    static void HmdTrackerCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_PoseReport* report);
+    bool detectDisplayOnDesktop();
 
+    /**
+     * Copies what the display queries need out of the display config, so
+     * they never touch the client context. Called with the context locked.
+     */
+    void captureDisplayConfig();
+
+    /**
+     * Measures the distance between the eyes in the display config. Provides
+     * Prop_UserIpdMeters_Float, so it locks the context itself.
+     */
     float GetIPD();
 
     /**
@@ -120,10 +166,56 @@ private:
      */
     void configureDistortionParameters();
 
+    /**
+     * Build the mesh interpolators and bake the distortion grid for one eye.
+     * Runs on a worker thread started by configureDistortionParameters().
+     */
+    void configureEyeDistortion(size_t eye);
+
+    /**
+     * Join the per-eye distortion workers and cache their results.
+     */
+    void waitForDistortionParameters();
+
+    /**
+     * Load the distortion grids from the on-disk cache.
+     *
+     * @return @c true if the cache held grids for the current display
+     * descriptor, one for each of the display's two eyes.
+     */
+    bool loadDistortionGrids();
+
+    /**
+     * Store the distortion grids in the on-disk cache.
+     */
+    void saveDistortionGrids();
+
+    /**
+     * Returns the number of cells along each axis of the distortion grids. A
+     * setting of 0 picks a resolution that matches the density of the
+     * distortion mesh.
+     */
+    size_t getDistortionGridResolution() const;
+
     void configureProperties();
 
+    /**
+     * Returns the time from vsync until the panel emits photons: a fixed
+     * panel latency plus the part of the frame period spent scanning out
+     * before the panel lights up.
+     */
+    float getSecondsFromVsyncToPhotons() const;
+
     std::string displayDescription_;
     osvr::clientkit::DisplayConfig displayConfig_;
+
+    /** \name Copied from displayConfig_ by captureDisplayConfig(). */
+    //@{
+    osvr::clientkit::DisplayDimensions displayDimensions_ = {};
+    std::array<osvr::clientkit::RelativeViewport, 2> eyeViewports_ = {};
+    std::array<osvr::clientkit::ProjectionClippingPlanes, 2> eyeProjections_ = {};
+    //@}
+
     osvr::client::RenderManagerConfig renderManagerConfig_;
     osvr::clientkit::Interface trackerInterface_;
     std::vector<osvr::renderkit::DistortionParameters> distortionParameters_;
@@ -134,10 +226,24 @@ private:
     MeshInterpolators leftEyeInterpolators_;
     MeshInterpolators rightEyeInterpolators_;
 
+    // per-eye distortion lookup tables
+    std::vector<DistortionGrid> distortionGrids_;
+    std::unique_ptr<DistortionCache> distortionCache_;
+
+    // per-eye distortion workers, joined by continueActivation()
+    std::vector<std::future<void>> distortionTasks_;
+
     float overfillFactor_ = 1.0; // TODO get from RenderManager
 
+    std::unique_ptr<osvr::display::DisplayCache> displayCache_;
+
     // Settings
+    std::string userDriverConfigDir_;
     osvr::display::Display display_ = {};
+    int32_t distortionGridResolution_ = 0;
+    bool exactDistortion_ = false;
+    float panelLatencySeconds_ = 0.0f; // pixel response and panel processing
+    float panelScanoutFraction_ = 1.0f; // frames of scanout before photons
 };
 
 #endif // INCLUDED_OSVRTrackedHMD_h_GUID_233AC6EA_4833_4EE2_B4ED_1F60A2208C9D
@@ -65,14 +65,11 @@ vr::EVRInitError OSVRTrackingReference::Activate(uint32_t object_id)
     OSVRTrackedDevice::Activate(object_id);
 
     // Clean up tracker callback if exists
+    auto lock = lockContext();
     if (m_TrackerInterface.notEmpty()) {
         m_TrackerInterface.free();
     }
 
-    // Register tracker callback
-    m_TrackerInterface = context_.getInterface(trackerPath_);
-    m_TrackerInterface.registerCallback(&OSVRTrackingReference::TrackerCallback, this);
-
     return vr::VRInitError_None;
 }
 
@@ -80,51 +77,27 @@ void OSVRTrackingReference::Deactivate()
 {
     OSVR_LOG(trace) << "OSVRTrackingReference::Deactivate() called.";
 
+    OSVRTrackedDevice::Deactivate();
+
     // Clean up tracker callback if exists
+    auto lock = lockContext();
     if (m_TrackerInterface.notEmpty()) {
         m_TrackerInterface.free();
     }
 }
 
-const char* OSVRTrackingReference::GetId()
+OSVRTrackedDevice::ActivationStatus OSVRTrackingReference::continueActivation()
 {
-    return "OSVR IR camera";
+    // Register tracker callback
+    m_TrackerInterface = context_.getInterface(trackerPath_);
+    m_TrackerInterface.registerCallback(&OSVRTrackedDevice::trackerCallback<OSVR_PoseReport>, static_cast<OSVRTrackedDevice*>(this));
+
+    return ActivationStatus::Succeeded;
 }
 
-void OSVRTrackingReference::TrackerCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_PoseReport* report)
+const char* OSVRTrackingReference::GetId()
 {
-    if (!userdata)
-        return;
-
-    auto* self = static_cast<OSVRTrackingReference*>(userdata);
-
-    vr::DriverPose_t pose;
-    pose.poseTimeOffset = 0; // close enough
-    Eigen::Vector3d::Map(pose.vecWorldFromDriverTranslation) = Eigen::Vector3d::Zero();
-    Eigen::Vector3d::Map(pose.vecDriverFromHeadTranslation) = Eigen::Vector3d::Zero();
-    map(pose.qWorldFromDriverRotation) = Eigen::Quaterniond::Identity();
-    map(pose.qDriverFromHeadRotation) = Eigen::Quaterniond::Identity();
-
-    // Position
-    Eigen::Vector3d::Map(pose.vecPosition) = osvr::util::vecMap(report->pose.translation);
-
-    // Position velocity and acceleration are not currently consistently provided
-    Eigen::Vector3d::Map(pose.vecVelocity) = Eigen::Vector3d::Zero();
-    Eigen::Vector3d::Map(pose.vecAcceleration) = Eigen::Vector3d::Zero();
-
-    // Orientation
-    map(pose.qRotation) = osvr::util::fromQuat(report->pose.rotation);
-
-    // Angular velocity and acceleration are not currently consistently provided
-    Eigen::Vector3d::Map(pose.vecAngularVelocity) = Eigen::Vector3d::Zero();
-    Eigen::Vector3d::Map(pose.vecAngularAcceleration) = Eigen::Vector3d::Zero();
-
-    pose.result = vr::TrackingResult_Running_OK;
-    pose.poseIsValid = true;
-    pose.willDriftInYaw = false;
-    pose.shouldApplyHeadModel = false;
-    self->pose_ = pose;
-    self->driverHost_->TrackedDevicePoseUpdated(self->objectId_, self->pose_);
+    return "OSVR IR camera";
 }
 
 void OSVRTrackingReference::configure()
@@ -138,53 +111,55 @@ void OSVRTrackingReference::configure()
     minTrackingRange_ = settings_->getSetting<float>("minTrackingRangeMeters", minTrackingRange_);
     maxTrackingRange_ = settings_->getSetting<float>("maxTrackingRangeMeters", maxTrackingRange_);
 
+    configurePoseCalibration("driver_osvr_trackingreference");
+
     configureProperties();
 }
 
 void OSVRTrackingReference::configureProperties()
 {
     // Properties that apply to all device classes
-    properties_[vr::Prop_WillDriftInYaw_Bool] = false;
-    properties_[vr::Prop_DeviceIsWireless_Bool] = false;
-    properties_[vr::Prop_DeviceIsCharging_Bool] = false;
-    properties_[vr::Prop_Firmware_UpdateAvailable_Bool] = false;
-    properties_[vr::Prop_Firmware_ManualUpdate_Bool] = false;
-    properties_[vr::Prop_BlockServerShutdown_Bool] = false;
-    //properties_[vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool] = true;
-    properties_[vr::Prop_ContainsProximitySensor_Bool] = false;
-    properties_[vr::Prop_DeviceProvidesBatteryStatus_Bool] = false;
-    properties_[vr::Prop_DeviceCanPowerOff_Bool] = false;
-    properties_[vr::Prop_HasCamera_Bool] = false;
-    properties_[vr::Prop_DeviceBatteryPercentage_Float] = 1.0f;
-    properties_[vr::Prop_DeviceClass_Int32] = deviceClass_;
-    //properties_[vr::Prop_HardwareRevision_Uint64] = 0ul;
-    //properties_[vr::Prop_FirmwareVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_FPGAVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_VRCVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_RadioVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_DongleVersion_Uint64] = 0ul;
-    //properties_[vr::Prop_StatusDisplayTransform_Matrix34] = /* ... */;
-    //properties_[vr::Prop_TrackingSystemName_String] = "";
-    properties_[vr::Prop_ModelNumber_String] = "OSVR Tracking Reference";
-    properties_[vr::Prop_SerialNumber_String] = GetId();
-    properties_[vr::Prop_RenderModelName_String] = "dk2_camera"; // FIXME replace with HDK IR camera model
-    properties_[vr::Prop_ManufacturerName_String] = "OSVR"; // FIXME read value from server
-    //properties_[vr::Prop_TrackingFirmwareVersion_String] = "";
-    //properties_[vr::Prop_HardwareRevision_String] = "";
-    //properties_[vr::Prop_AllWirelessDongleDescriptions_String] = "";
-    //properties_[vr::Prop_ConnectedWirelessDongle_String] = "";
-    //properties_[vr::Prop_Firmware_ManualUpdateURL_String] = "";
-    //properties_[vr::Prop_Firmware_ProgrammingTarget_String] = "";
-    //properties_[vr::Prop_DriverVersion_String] = "";
+    properties_.set<vr::Prop_WillDriftInYaw_Bool>(false);
+    properties_.set<vr::Prop_DeviceIsWireless_Bool>(false);
+    properties_.set<vr::Prop_DeviceIsCharging_Bool>(false);
+    properties_.set<vr::Prop_Firmware_UpdateAvailable_Bool>(false);
+    properties_.set<vr::Prop_Firmware_ManualUpdate_Bool>(false);
+    properties_.set<vr::Prop_BlockServerShutdown_Bool>(false);
+    //properties_.set<vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool>(true);
+    properties_.set<vr::Prop_ContainsProximitySensor_Bool>(false);
+    properties_.set<vr::Prop_DeviceProvidesBatteryStatus_Bool>(false);
+    properties_.set<vr::Prop_DeviceCanPowerOff_Bool>(false);
+    properties_.set<vr::Prop_HasCamera_Bool>(false);
+    properties_.set<vr::Prop_DeviceBatteryPercentage_Float>(1.0f);
+    properties_.set<vr::Prop_DeviceClass_Int32>(deviceClass_);
+    //properties_.set<vr::Prop_HardwareRevision_Uint64>(0ul);
+    //properties_.set<vr::Prop_FirmwareVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_FPGAVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_VRCVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_RadioVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_DongleVersion_Uint64>(0ul);
+    //properties_.set<vr::Prop_StatusDisplayTransform_Matrix34>(/* ... */);
+    //properties_.set<vr::Prop_TrackingSystemName_String>("");
+    properties_.set<vr::Prop_ModelNumber_String>("OSVR Tracking Reference");
+    properties_.set<vr::Prop_SerialNumber_String>(GetId());
+    properties_.set<vr::Prop_RenderModelName_String>("dk2_camera"); // FIXME replace with HDK IR camera model
+    properties_.set<vr::Prop_ManufacturerName_String>("OSVR"); // FIXME read value from server
+    //properties_.set<vr::Prop_TrackingFirmwareVersion_String>("");
+    //properties_.set<vr::Prop_HardwareRevision_String>("");
+    //properties_.set<vr::Prop_AllWirelessDongleDescriptions_String>("");
+    //properties_.set<vr::Prop_ConnectedWirelessDongle_String>("");
+    //properties_.set<vr::Prop_Firmware_ManualUpdateURL_String>("");
+    //properties_.set<vr::Prop_Firmware_ProgrammingTarget_String>("");
+    //properties_.set<vr::Prop_DriverVersion_String>("");
 
     // Properties that are unique to TrackedDeviceClass_TrackingReference
-    properties_[vr::Prop_FieldOfViewLeftDegrees_Float] = fovLeft_;
-    properties_[vr::Prop_FieldOfViewRightDegrees_Float] = fovRight_;
-    properties_[vr::Prop_FieldOfViewTopDegrees_Float] = fovTop_;
-    properties_[vr::Prop_FieldOfViewBottomDegrees_Float] = fovBottom_;
-    properties_[vr::Prop_TrackingRangeMinimumMeters_Float] = minTrackingRange_;
-    properties_[vr::Prop_TrackingRangeMaximumMeters_Float] = maxTrackingRange_;
-    //properties_[vr::Prop_ModeLabel_String] = "";
+    properties_.set<vr::Prop_FieldOfViewLeftDegrees_Float>(fovLeft_);
+    properties_.set<vr::Prop_FieldOfViewRightDegrees_Float>(fovRight_);
+    properties_.set<vr::Prop_FieldOfViewTopDegrees_Float>(fovTop_);
+    properties_.set<vr::Prop_FieldOfViewBottomDegrees_Float>(fovBottom_);
+    properties_.set<vr::Prop_TrackingRangeMinimumMeters_Float>(minTrackingRange_);
+    properties_.set<vr::Prop_TrackingRangeMaximumMeters_Float>(maxTrackingRange_);
+    //properties_.set<vr::Prop_ModeLabel_String>("");
 }
 
 
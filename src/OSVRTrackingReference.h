@@ -69,9 +69,12 @@ public:
 protected:
     const char* GetId();
 
-private:
-    static void TrackerCallback(void* userdata, const OSVR_TimeValue* timestamp, const OSVR_PoseReport* report);
+    /**
+     * Registers the tracker callback.
+     */
+    virtual ActivationStatus continueActivation() OSVR_OVERRIDE;
 
+private:
     /**
      * Read configuration settings from configuration file.
      */
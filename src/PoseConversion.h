@@ -0,0 +1,102 @@
+/** @file
+    @brief Conversion of OSVR tracker reports to OpenVR driver poses.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_PoseConversion_h_GUID_C7E1A94B_3F25_4D80_A6B9_19D4E8F2C053
+#define INCLUDED_PoseConversion_h_GUID_C7E1A94B_3F25_4D80_A6B9_19D4E8F2C053
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+#include <osvr/Util/ClientReportTypesC.h>
+
+// Standard includes
+// - none
+
+/**
+ * @brief Copies the tracked parts of an OSVR report into a driver pose.
+ *
+ * Specialized for each report type that can drive a tracked device.
+ */
+template <typename Report>
+struct PoseReportTraits;
+
+template <>
+struct PoseReportTraits<OSVR_PositionReport> {
+    static void apply(const OSVR_PositionReport& report, vr::DriverPose_t& pose)
+    {
+        apply(report.xyz, pose);
+    }
+
+    static void apply(const OSVR_Vec3& translation, vr::DriverPose_t& pose)
+    {
+        pose.vecPosition[0] = translation.data[0];
+        pose.vecPosition[1] = translation.data[1];
+        pose.vecPosition[2] = translation.data[2];
+    }
+};
+
+template <>
+struct PoseReportTraits<OSVR_OrientationReport> {
+    static void apply(const OSVR_OrientationReport& report, vr::DriverPose_t& pose)
+    {
+        apply(report.rotation, pose);
+    }
+
+    static void apply(const OSVR_Quaternion& rotation, vr::DriverPose_t& pose)
+    {
+        // OSVR stores quaternions as (w, x, y, z)
+        pose.qRotation.w = rotation.data[0];
+        pose.qRotation.x = rotation.data[1];
+        pose.qRotation.y = rotation.data[2];
+        pose.qRotation.z = rotation.data[3];
+    }
+};
+
+template <>
+struct PoseReportTraits<OSVR_PoseReport> {
+    static void apply(const OSVR_PoseReport& report, vr::DriverPose_t& pose)
+    {
+        PoseReportTraits<OSVR_PositionReport>::apply(report.pose.translation, pose);
+        PoseReportTraits<OSVR_OrientationReport>::apply(report.pose.rotation, pose);
+    }
+};
+
+/**
+ * Builds a driver pose from @p report. Everything the report doesn't carry
+ * (calibration transforms, derivatives, status flags) comes from the
+ * device's preinitialized @p pose_template, so only the tracked fields are
+ * touched per report.
+ */
+template <typename Report>
+inline vr::DriverPose_t convertPose(const vr::DriverPose_t& pose_template, const Report& report)
+{
+    vr::DriverPose_t pose = pose_template;
+    PoseReportTraits<Report>::apply(report, pose);
+    return pose;
+}
+
+#endif // INCLUDED_PoseConversion_h_GUID_C7E1A94B_3F25_4D80_A6B9_19D4E8F2C053
@@ -0,0 +1,158 @@
+/** @file
+    @brief Estimates pose derivatives from a short history of tracker reports.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "PosePredictor.h"
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+#include <osvr/Util/TimeValueC.h>
+
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
+#include <Eigen/Geometry>
+
+// Standard includes
+#include <algorithm>        // for std::max
+#include <cstddef>
+
+namespace {
+
+// Samples closer together than this don't constrain a fit.
+const double MIN_TIME_SPAN = 1e-4; // seconds
+
+/**
+ * Least-squares fit of y(t) = c + v t + a t^2 / 2 to @p count samples, where
+ * t is relative to the newest sample. If @p fit_acceleration is false, a
+ * straight line is fit instead and @p acceleration is zero.
+ */
+void fitDerivatives(const double* t, const Eigen::Vector3d* y, std::size_t count, bool fit_acceleration, Eigen::Vector3d& velocity, Eigen::Vector3d& acceleration)
+{
+    velocity.setZero();
+    acceleration.setZero();
+
+    if (fit_acceleration) {
+        Eigen::Matrix3d normal = Eigen::Matrix3d::Zero();
+        Eigen::Matrix3d rhs = Eigen::Matrix3d::Zero();
+        for (std::size_t i = 0; i < count; ++i) {
+            const Eigen::Vector3d basis(1.0, t[i], 0.5 * t[i] * t[i]);
+            normal += basis * basis.transpose();
+            rhs += basis * y[i].transpose();
+        }
+        const Eigen::Matrix3d solution = normal.ldlt().solve(rhs);
+        velocity = solution.row(1).transpose();
+        acceleration = solution.row(2).transpose();
+    } else {
+        Eigen::Matrix2d normal = Eigen::Matrix2d::Zero();
+        Eigen::Matrix<double, 2, 3> rhs = Eigen::Matrix<double, 2, 3>::Zero();
+        for (std::size_t i = 0; i < count; ++i) {
+            const Eigen::Vector2d basis(1.0, t[i]);
+            normal += basis * basis.transpose();
+            rhs += basis * y[i].transpose();
+        }
+        const Eigen::Matrix<double, 2, 3> solution = normal.ldlt().solve(rhs);
+        velocity = solution.row(1).transpose();
+    }
+
+    if (!velocity.allFinite() || !acceleration.allFinite()) {
+        velocity.setZero();
+        acceleration.setZero();
+    }
+}
+
+} // end anonymous namespace
+
+PosePredictor::PosePredictor(std::size_t history_size, double max_history_age) : history_(std::max<std::size_t>(history_size, 2)), maxHistoryAge_(max_history_age)
+{
+    // do nothing
+}
+
+void PosePredictor::update(const OSVR_TimeValue& timestamp, vr::DriverPose_t& pose)
+{
+    const Eigen::Vector3d position = Eigen::Vector3d::Map(pose.vecPosition);
+    const Quaternion orientation(pose.qRotation.w, pose.qRotation.x, pose.qRotation.y, pose.qRotation.z);
+
+    // Out-of-order or stale reports invalidate the history
+    if (count_ > 0) {
+        const auto& newest = history_[(next_ + history_.size() - 1) % history_.size()];
+        if (osvrTimeValueDurationSeconds(&timestamp, &newest.timestamp) <= 0.0)
+            reset();
+    }
+
+    history_[next_] = Sample { timestamp, position, orientation };
+    next_ = (next_ + 1) % history_.size();
+    count_ = std::min(count_ + 1, history_.size());
+
+    // Express the history relative to the newest report: times are <= 0,
+    // positions are absolute, and orientations are rotation vectors taking
+    // the newest orientation to the older one.
+    const std::size_t max_samples = 32;
+    double t[max_samples];
+    Eigen::Vector3d linear[max_samples];
+    Eigen::Vector3d angular[max_samples];
+    std::size_t samples = 0;
+    for (std::size_t i = 0; i < count_ && samples < max_samples; ++i) {
+        const auto& sample = history_[(next_ + history_.size() - 1 - i) % history_.size()];
+        const auto age = osvrTimeValueDurationSeconds(&sample.timestamp, &timestamp);
+        if (-age > maxHistoryAge_)
+            break;
+
+        Eigen::Quaterniond delta = sample.orientation * orientation.conjugate();
+        if (delta.w() < 0.0)
+            delta.coeffs() *= -1.0; // take the short way around
+        const Eigen::AngleAxisd angle_axis(delta);
+
+        t[samples] = age;
+        linear[samples] = sample.position;
+        angular[samples] = angle_axis.angle() * angle_axis.axis();
+        ++samples;
+    }
+
+    Eigen::Vector3d velocity = Eigen::Vector3d::Zero();
+    Eigen::Vector3d acceleration = Eigen::Vector3d::Zero();
+    Eigen::Vector3d angular_velocity = Eigen::Vector3d::Zero();
+    Eigen::Vector3d angular_acceleration = Eigen::Vector3d::Zero();
+    if (samples >= 2 && -t[samples - 1] >= MIN_TIME_SPAN) {
+        const bool fit_acceleration = samples >= 3;
+        fitDerivatives(t, linear, samples, fit_acceleration, velocity, acceleration);
+        fitDerivatives(t, angular, samples, fit_acceleration, angular_velocity, angular_acceleration);
+    }
+
+    // The rotation vectors are in the tracking frame, but SteamVR takes
+    // angular rates relative to the device's own axes.
+    const Eigen::Quaterniond local_from_tracking = Eigen::Quaterniond(orientation).conjugate();
+
+    Eigen::Vector3d::Map(pose.vecVelocity) = velocity;
+    Eigen::Vector3d::Map(pose.vecAcceleration) = acceleration;
+    Eigen::Vector3d::Map(pose.vecAngularVelocity) = local_from_tracking * angular_velocity;
+    Eigen::Vector3d::Map(pose.vecAngularAcceleration) = local_from_tracking * angular_acceleration;
+}
+
+void PosePredictor::reset()
+{
+    next_ = 0;
+    count_ = 0;
+}
@@ -0,0 +1,93 @@
+/** @file
+    @brief Estimates pose derivatives from a short history of tracker reports.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_PosePredictor_h_GUID_0F6A3B2D_91C4_4E7A_8D53_B2E74A1C96F0
+#define INCLUDED_PosePredictor_h_GUID_0F6A3B2D_91C4_4E7A_8D53_B2E74A1C96F0
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+#include <osvr/Util/TimeValueC.h>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+// Standard includes
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Keeps a short history of timestamped poses for one device and fills
+ * in the linear and angular velocity and acceleration of each new pose so
+ * that SteamVR can extrapolate it.
+ *
+ * Derivatives are estimated with a least-squares fit of a quadratic in time
+ * to the history, evaluated at the newest report. Linear rates are in the
+ * tracking frame; angular rates are rotation vectors (right-handed, in
+ * radians) about the device's own axes, i.e., relative to qRotation.
+ *
+ * The fit amplifies tracker noise, so devices only use it when the
+ * posePrediction setting is enabled.
+ */
+class PosePredictor {
+public:
+    /**
+     * @param history_size number of reports to fit against.
+     * @param max_history_age reports older than this many seconds relative to
+     *     the newest one are ignored.
+     */
+    explicit PosePredictor(std::size_t history_size = 8, double max_history_age = 0.1);
+
+    /**
+     * Records @p pose, reported at @p timestamp, and overwrites its velocity
+     * and acceleration fields with estimates from the history.
+     */
+    void update(const OSVR_TimeValue& timestamp, vr::DriverPose_t& pose);
+
+    /**
+     * Forgets all history, e.g., after tracking was lost.
+     */
+    void reset();
+
+private:
+    // Unaligned so that samples can be stored in a std::vector
+    using Quaternion = Eigen::Quaternion<double, Eigen::DontAlign>;
+
+    struct Sample {
+        OSVR_TimeValue timestamp;
+        Eigen::Vector3d position;
+        Quaternion orientation;
+    };
+
+    std::vector<Sample> history_; ///< ring buffer of samples
+    std::size_t next_ = 0;        ///< slot to write the next sample to
+    std::size_t count_ = 0;       ///< number of valid samples
+    double maxHistoryAge_;
+};
+
+#endif // INCLUDED_PosePredictor_h_GUID_0F6A3B2D_91C4_4E7A_8D53_B2E74A1C96F0
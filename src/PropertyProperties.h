@@ -32,734 +32,324 @@
 #include <openvr_driver.h>
 
 // Standard includes
-// - none
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
 
-// Whenever you upgrade OpenVR, make sure you update all the functions below if vr::ETrackedDeviceProperty has changed.
+// Whenever you upgrade OpenVR, make sure you update this list if
+// vr::ETrackedDeviceProperty has changed.
 
-inline bool isWrongDataType(vr::ETrackedDeviceProperty prop, const bool&)
-{
-    switch (prop) {
-    case vr::Prop_WillDriftInYaw_Bool:
-    case vr::Prop_DeviceIsWireless_Bool:
-    case vr::Prop_DeviceIsCharging_Bool:
-    case vr::Prop_Firmware_UpdateAvailable_Bool:
-    case vr::Prop_Firmware_ManualUpdate_Bool:
-    case vr::Prop_BlockServerShutdown_Bool:
-    case vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool:
-    case vr::Prop_ContainsProximitySensor_Bool:
-    case vr::Prop_DeviceProvidesBatteryStatus_Bool:
-    case vr::Prop_DeviceCanPowerOff_Bool:
-    case vr::Prop_HasCamera_Bool:
-    case vr::Prop_ReportsTimeSinceVSync_Bool:
-    case vr::Prop_IsOnDesktop_Bool:
-    case vr::Prop_Firmware_ForceUpdateRequired_Bool:
-    case vr::Prop_DisplaySuppressed_Bool:
-    // could be any type
-    case vr::Prop_VendorSpecific_Reserved_Start:
-    case vr::Prop_VendorSpecific_Reserved_End:
-        return false;
-    // Float
-    case vr::Prop_DeviceBatteryPercentage_Float:
-    case vr::Prop_SecondsFromVsyncToPhotons_Float:
-    case vr::Prop_DisplayFrequency_Float:
-    case vr::Prop_UserIpdMeters_Float:
-    case vr::Prop_DisplayMCOffset_Float:
-    case vr::Prop_DisplayMCScale_Float:
-    case vr::Prop_DisplayGCBlackClamp_Float:
-    case vr::Prop_DisplayGCOffset_Float:
-    case vr::Prop_DisplayGCScale_Float:
-    case vr::Prop_DisplayGCPrescale_Float:
-    case vr::Prop_LensCenterLeftU_Float:
-    case vr::Prop_LensCenterLeftV_Float:
-    case vr::Prop_LensCenterRightU_Float:
-    case vr::Prop_LensCenterRightV_Float:
-    case vr::Prop_UserHeadToEyeDepthMeters_Float:
-    case vr::Prop_FieldOfViewLeftDegrees_Float:
-    case vr::Prop_FieldOfViewRightDegrees_Float:
-    case vr::Prop_FieldOfViewTopDegrees_Float:
-    case vr::Prop_FieldOfViewBottomDegrees_Float:
-    case vr::Prop_TrackingRangeMinimumMeters_Float:
-    case vr::Prop_TrackingRangeMaximumMeters_Float:
-    case vr::Prop_ScreenshotHorizontalFieldOfViewDegrees_Float:
-    case vr::Prop_ScreenshotVerticalFieldOfViewDegrees_Float:
-    // Int32
-    case vr::Prop_DeviceClass_Int32:
-    case vr::Prop_DisplayMCType_Int32:
-    case vr::Prop_EdidVendorID_Int32:
-    case vr::Prop_EdidProductID_Int32:
-    case vr::Prop_DisplayGCType_Int32:
-    case vr::Prop_Axis0Type_Int32:
-    case vr::Prop_Axis1Type_Int32:
-    case vr::Prop_Axis2Type_Int32:
-    case vr::Prop_Axis3Type_Int32:
-    case vr::Prop_Axis4Type_Int32:
-    case vr::Prop_CameraCompatibilityMode_Int32:
-    // Uint64
-    case vr::Prop_HardwareRevision_Uint64:
-    case vr::Prop_FirmwareVersion_Uint64:
-    case vr::Prop_FPGAVersion_Uint64:
-    case vr::Prop_VRCVersion_Uint64:
-    case vr::Prop_RadioVersion_Uint64:
-    case vr::Prop_DongleVersion_Uint64:
-    case vr::Prop_CurrentUniverseId_Uint64:
-    case vr::Prop_PreviousUniverseId_Uint64:
-    case vr::Prop_DisplayFirmwareVersion_Uint64:
-    case vr::Prop_CameraFirmwareVersion_Uint64:
-    case vr::Prop_DisplayFPGAVersion_Uint64:
-    case vr::Prop_DisplayBootloaderVersion_Uint64:
-    case vr::Prop_DisplayHardwareVersion_Uint64:
-    case vr::Prop_AudioFirmwareVersion_Uint64:
-    case vr::Prop_SupportedButtons_Uint64:
-    // String
-    case vr::Prop_TrackingSystemName_String:
-    case vr::Prop_ModelNumber_String:
-    case vr::Prop_SerialNumber_String:
-    case vr::Prop_RenderModelName_String:
-    case vr::Prop_ManufacturerName_String:
-    case vr::Prop_TrackingFirmwareVersion_String:
-    case vr::Prop_HardwareRevision_String:
-    case vr::Prop_AllWirelessDongleDescriptions_String:
-    case vr::Prop_ConnectedWirelessDongle_String:
-    case vr::Prop_Firmware_ManualUpdateURL_String:
-    case vr::Prop_Firmware_ProgrammingTarget_String:
-    case vr::Prop_DisplayMCImageLeft_String:
-    case vr::Prop_DisplayMCImageRight_String:
-    case vr::Prop_DisplayGCImage_String:
-    case vr::Prop_CameraFirmwareDescription_String:
-    case vr::Prop_AttachedDeviceId_String:
-    case vr::Prop_ModeLabel_String:
-    case vr::Prop_DriverVersion_String:
-    // Matrix34
-    case vr::Prop_StatusDisplayTransform_Matrix34:
-    case vr::Prop_CameraToHeadTransform_Matrix34:
-        return true;
-    }
+/**
+ * Every OpenVR property with the type of its value and the class of device
+ * it applies to. Vendor-specific properties are handled separately.
+ *
+ * X(property, PropertyType, PropertyOwner)
+ */
+#define OSVR_TRACKED_DEVICE_PROPERTIES(X) \
+    /* General properties that apply to all device classes */ \
+    X(Prop_TrackingSystemName_String,                  String,   All) \
+    X(Prop_ModelNumber_String,                         String,   All) \
+    X(Prop_SerialNumber_String,                        String,   All) \
+    X(Prop_RenderModelName_String,                     String,   All) \
+    X(Prop_WillDriftInYaw_Bool,                        Bool,     All) \
+    X(Prop_ManufacturerName_String,                    String,   All) \
+    X(Prop_TrackingFirmwareVersion_String,             String,   All) \
+    X(Prop_HardwareRevision_String,                    String,   All) \
+    X(Prop_AllWirelessDongleDescriptions_String,       String,   All) \
+    X(Prop_ConnectedWirelessDongle_String,             String,   All) \
+    X(Prop_DeviceIsWireless_Bool,                      Bool,     All) \
+    X(Prop_DeviceIsCharging_Bool,                      Bool,     All) \
+    X(Prop_DeviceBatteryPercentage_Float,              Float,    All) \
+    X(Prop_StatusDisplayTransform_Matrix34,            Matrix34, All) \
+    X(Prop_Firmware_UpdateAvailable_Bool,              Bool,     All) \
+    X(Prop_Firmware_ManualUpdate_Bool,                 Bool,     All) \
+    X(Prop_Firmware_ManualUpdateURL_String,            String,   All) \
+    X(Prop_HardwareRevision_Uint64,                    Uint64,   All) \
+    X(Prop_FirmwareVersion_Uint64,                     Uint64,   All) \
+    X(Prop_FPGAVersion_Uint64,                         Uint64,   All) \
+    X(Prop_VRCVersion_Uint64,                          Uint64,   All) \
+    X(Prop_RadioVersion_Uint64,                        Uint64,   All) \
+    X(Prop_DongleVersion_Uint64,                       Uint64,   All) \
+    X(Prop_BlockServerShutdown_Bool,                   Bool,     All) \
+    X(Prop_CanUnifyCoordinateSystemWithHmd_Bool,       Bool,     All) \
+    X(Prop_ContainsProximitySensor_Bool,               Bool,     All) \
+    X(Prop_DeviceProvidesBatteryStatus_Bool,           Bool,     All) \
+    X(Prop_DeviceCanPowerOff_Bool,                     Bool,     All) \
+    X(Prop_Firmware_ProgrammingTarget_String,          String,   All) \
+    X(Prop_DeviceClass_Int32,                          Int32,    All) \
+    X(Prop_HasCamera_Bool,                             Bool,     All) \
+    X(Prop_Firmware_ForceUpdateRequired_Bool,          Bool,     All) \
+    X(Prop_DriverVersion_String,                       String,   All) \
+    /* Properties that are unique to TrackedDeviceClass_HMD */ \
+    X(Prop_ReportsTimeSinceVSync_Bool,                 Bool,     HMD) \
+    X(Prop_SecondsFromVsyncToPhotons_Float,            Float,    HMD) \
+    X(Prop_DisplayFrequency_Float,                     Float,    HMD) \
+    X(Prop_UserIpdMeters_Float,                        Float,    HMD) \
+    X(Prop_CurrentUniverseId_Uint64,                   Uint64,   HMD) \
+    X(Prop_PreviousUniverseId_Uint64,                  Uint64,   HMD) \
+    X(Prop_DisplayFirmwareVersion_Uint64,              Uint64,   HMD) \
+    X(Prop_IsOnDesktop_Bool,                           Bool,     HMD) \
+    X(Prop_DisplayMCType_Int32,                        Int32,    HMD) \
+    X(Prop_DisplayMCOffset_Float,                      Float,    HMD) \
+    X(Prop_DisplayMCScale_Float,                       Float,    HMD) \
+    X(Prop_EdidVendorID_Int32,                         Int32,    HMD) \
+    X(Prop_DisplayMCImageLeft_String,                  String,   HMD) \
+    X(Prop_DisplayMCImageRight_String,                 String,   HMD) \
+    X(Prop_DisplayGCBlackClamp_Float,                  Float,    HMD) \
+    X(Prop_EdidProductID_Int32,                        Int32,    HMD) \
+    X(Prop_CameraToHeadTransform_Matrix34,             Matrix34, HMD) \
+    X(Prop_DisplayGCType_Int32,                        Int32,    HMD) \
+    X(Prop_DisplayGCOffset_Float,                      Float,    HMD) \
+    X(Prop_DisplayGCScale_Float,                       Float,    HMD) \
+    X(Prop_DisplayGCPrescale_Float,                    Float,    HMD) \
+    X(Prop_DisplayGCImage_String,                      String,   HMD) \
+    X(Prop_LensCenterLeftU_Float,                      Float,    HMD) \
+    X(Prop_LensCenterLeftV_Float,                      Float,    HMD) \
+    X(Prop_LensCenterRightU_Float,                     Float,    HMD) \
+    X(Prop_LensCenterRightV_Float,                     Float,    HMD) \
+    X(Prop_UserHeadToEyeDepthMeters_Float,             Float,    HMD) \
+    X(Prop_CameraFirmwareVersion_Uint64,               Uint64,   HMD) \
+    X(Prop_CameraFirmwareDescription_String,           String,   HMD) \
+    X(Prop_DisplayFPGAVersion_Uint64,                  Uint64,   HMD) \
+    X(Prop_DisplayBootloaderVersion_Uint64,            Uint64,   HMD) \
+    X(Prop_DisplayHardwareVersion_Uint64,              Uint64,   HMD) \
+    X(Prop_AudioFirmwareVersion_Uint64,                Uint64,   HMD) \
+    X(Prop_CameraCompatibilityMode_Int32,              Int32,    HMD) \
+    X(Prop_ScreenshotHorizontalFieldOfViewDegrees_Float, Float,  HMD) \
+    X(Prop_ScreenshotVerticalFieldOfViewDegrees_Float, Float,    HMD) \
+    X(Prop_DisplaySuppressed_Bool,                     Bool,     HMD) \
+    /* Properties that are unique to TrackedDeviceClass_Controller */ \
+    X(Prop_AttachedDeviceId_String,                    String,   Controller) \
+    X(Prop_SupportedButtons_Uint64,                    Uint64,   Controller) \
+    X(Prop_Axis0Type_Int32,                            Int32,    Controller) \
+    X(Prop_Axis1Type_Int32,                            Int32,    Controller) \
+    X(Prop_Axis2Type_Int32,                            Int32,    Controller) \
+    X(Prop_Axis3Type_Int32,                            Int32,    Controller) \
+    X(Prop_Axis4Type_Int32,                            Int32,    Controller) \
+    /* Properties that are unique to TrackedDeviceClass_TrackingReference */ \
+    X(Prop_FieldOfViewLeftDegrees_Float,               Float,    TrackingReference) \
+    X(Prop_FieldOfViewRightDegrees_Float,              Float,    TrackingReference) \
+    X(Prop_FieldOfViewTopDegrees_Float,                Float,    TrackingReference) \
+    X(Prop_FieldOfViewBottomDegrees_Float,             Float,    TrackingReference) \
+    X(Prop_TrackingRangeMinimumMeters_Float,           Float,    TrackingReference) \
+    X(Prop_TrackingRangeMaximumMeters_Float,           Float,    TrackingReference) \
+    X(Prop_ModeLabel_String,                           String,   TrackingReference)
 
-    return true;
-}
+/**
+ * The type of a property's value.
+ */
+enum class PropertyType : uint8_t {
+    None,   ///< not a known property
+    Bool,
+    Float,
+    Int32,
+    Uint64,
+    String,
+    Matrix34,
+    Any     ///< vendor-specific properties may hold any type
+};
 
-inline bool isWrongDataType(vr::ETrackedDeviceProperty prop, const float&)
-{
-    switch (prop) {
-    case vr::Prop_DeviceBatteryPercentage_Float:
-    case vr::Prop_SecondsFromVsyncToPhotons_Float:
-    case vr::Prop_DisplayFrequency_Float:
-    case vr::Prop_UserIpdMeters_Float:
-    case vr::Prop_DisplayMCOffset_Float:
-    case vr::Prop_DisplayMCScale_Float:
-    case vr::Prop_DisplayGCBlackClamp_Float:
-    case vr::Prop_DisplayGCOffset_Float:
-    case vr::Prop_DisplayGCScale_Float:
-    case vr::Prop_DisplayGCPrescale_Float:
-    case vr::Prop_LensCenterLeftU_Float:
-    case vr::Prop_LensCenterLeftV_Float:
-    case vr::Prop_LensCenterRightU_Float:
-    case vr::Prop_LensCenterRightV_Float:
-    case vr::Prop_UserHeadToEyeDepthMeters_Float:
-    case vr::Prop_FieldOfViewLeftDegrees_Float:
-    case vr::Prop_FieldOfViewRightDegrees_Float:
-    case vr::Prop_FieldOfViewTopDegrees_Float:
-    case vr::Prop_FieldOfViewBottomDegrees_Float:
-    case vr::Prop_TrackingRangeMinimumMeters_Float:
-    case vr::Prop_TrackingRangeMaximumMeters_Float:
-    case vr::Prop_ScreenshotHorizontalFieldOfViewDegrees_Float:
-    case vr::Prop_ScreenshotVerticalFieldOfViewDegrees_Float:
-    // could be any type
-    case vr::Prop_VendorSpecific_Reserved_Start:
-    case vr::Prop_VendorSpecific_Reserved_End:
-        return false;
-    // Bool
-    case vr::Prop_WillDriftInYaw_Bool:
-    case vr::Prop_DeviceIsWireless_Bool:
-    case vr::Prop_DeviceIsCharging_Bool:
-    case vr::Prop_Firmware_UpdateAvailable_Bool:
-    case vr::Prop_Firmware_ManualUpdate_Bool:
-    case vr::Prop_BlockServerShutdown_Bool:
-    case vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool:
-    case vr::Prop_ContainsProximitySensor_Bool:
-    case vr::Prop_DeviceProvidesBatteryStatus_Bool:
-    case vr::Prop_DeviceCanPowerOff_Bool:
-    case vr::Prop_HasCamera_Bool:
-    case vr::Prop_ReportsTimeSinceVSync_Bool:
-    case vr::Prop_IsOnDesktop_Bool:
-    case vr::Prop_Firmware_ForceUpdateRequired_Bool:
-    case vr::Prop_DisplaySuppressed_Bool:
-    // Int32
-    case vr::Prop_DeviceClass_Int32:
-    case vr::Prop_DisplayMCType_Int32:
-    case vr::Prop_EdidVendorID_Int32:
-    case vr::Prop_EdidProductID_Int32:
-    case vr::Prop_DisplayGCType_Int32:
-    case vr::Prop_Axis0Type_Int32:
-    case vr::Prop_Axis1Type_Int32:
-    case vr::Prop_Axis2Type_Int32:
-    case vr::Prop_Axis3Type_Int32:
-    case vr::Prop_Axis4Type_Int32:
-    case vr::Prop_CameraCompatibilityMode_Int32:
-    // Uint64
-    case vr::Prop_HardwareRevision_Uint64:
-    case vr::Prop_FirmwareVersion_Uint64:
-    case vr::Prop_FPGAVersion_Uint64:
-    case vr::Prop_VRCVersion_Uint64:
-    case vr::Prop_RadioVersion_Uint64:
-    case vr::Prop_DongleVersion_Uint64:
-    case vr::Prop_CurrentUniverseId_Uint64:
-    case vr::Prop_PreviousUniverseId_Uint64:
-    case vr::Prop_DisplayFirmwareVersion_Uint64:
-    case vr::Prop_CameraFirmwareVersion_Uint64:
-    case vr::Prop_DisplayFPGAVersion_Uint64:
-    case vr::Prop_DisplayBootloaderVersion_Uint64:
-    case vr::Prop_DisplayHardwareVersion_Uint64:
-    case vr::Prop_AudioFirmwareVersion_Uint64:
-    case vr::Prop_SupportedButtons_Uint64:
-    // String
-    case vr::Prop_TrackingSystemName_String:
-    case vr::Prop_ModelNumber_String:
-    case vr::Prop_SerialNumber_String:
-    case vr::Prop_RenderModelName_String:
-    case vr::Prop_ManufacturerName_String:
-    case vr::Prop_TrackingFirmwareVersion_String:
-    case vr::Prop_HardwareRevision_String:
-    case vr::Prop_AllWirelessDongleDescriptions_String:
-    case vr::Prop_ConnectedWirelessDongle_String:
-    case vr::Prop_Firmware_ManualUpdateURL_String:
-    case vr::Prop_Firmware_ProgrammingTarget_String:
-    case vr::Prop_DisplayMCImageLeft_String:
-    case vr::Prop_DisplayMCImageRight_String:
-    case vr::Prop_DisplayGCImage_String:
-    case vr::Prop_CameraFirmwareDescription_String:
-    case vr::Prop_AttachedDeviceId_String:
-    case vr::Prop_ModeLabel_String:
-    case vr::Prop_DriverVersion_String:
-    // Matrix34
-    case vr::Prop_StatusDisplayTransform_Matrix34:
-    case vr::Prop_CameraToHeadTransform_Matrix34:
-        return true;
-    }
+/**
+ * The class of device a property applies to.
+ */
+enum class PropertyOwner : uint8_t {
+    None,   ///< no device class
+    All,
+    HMD,
+    Controller,
+    TrackingReference
+};
 
-    return true;
-}
+struct PropertyInfo {
+    PropertyType type;
+    PropertyOwner owner;
+};
 
-inline bool isWrongDataType(vr::ETrackedDeviceProperty prop, const int32_t&)
-{
-    switch (prop) {
-    case vr::Prop_DeviceClass_Int32:
-    case vr::Prop_DisplayMCType_Int32:
-    case vr::Prop_EdidVendorID_Int32:
-    case vr::Prop_EdidProductID_Int32:
-    case vr::Prop_DisplayGCType_Int32:
-    case vr::Prop_Axis0Type_Int32:
-    case vr::Prop_Axis1Type_Int32:
-    case vr::Prop_Axis2Type_Int32:
-    case vr::Prop_Axis3Type_Int32:
-    case vr::Prop_Axis4Type_Int32:
-    case vr::Prop_CameraCompatibilityMode_Int32:
-    // could be any type
-    case vr::Prop_VendorSpecific_Reserved_Start:
-    case vr::Prop_VendorSpecific_Reserved_End:
-        return false;
-    // Bool
-    case vr::Prop_WillDriftInYaw_Bool:
-    case vr::Prop_DeviceIsWireless_Bool:
-    case vr::Prop_DeviceIsCharging_Bool:
-    case vr::Prop_Firmware_UpdateAvailable_Bool:
-    case vr::Prop_Firmware_ManualUpdate_Bool:
-    case vr::Prop_BlockServerShutdown_Bool:
-    case vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool:
-    case vr::Prop_ContainsProximitySensor_Bool:
-    case vr::Prop_DeviceProvidesBatteryStatus_Bool:
-    case vr::Prop_DeviceCanPowerOff_Bool:
-    case vr::Prop_HasCamera_Bool:
-    case vr::Prop_ReportsTimeSinceVSync_Bool:
-    case vr::Prop_IsOnDesktop_Bool:
-    case vr::Prop_Firmware_ForceUpdateRequired_Bool:
-    case vr::Prop_DisplaySuppressed_Bool:
-    // Float
-    case vr::Prop_DeviceBatteryPercentage_Float:
-    case vr::Prop_SecondsFromVsyncToPhotons_Float:
-    case vr::Prop_DisplayFrequency_Float:
-    case vr::Prop_UserIpdMeters_Float:
-    case vr::Prop_DisplayMCOffset_Float:
-    case vr::Prop_DisplayMCScale_Float:
-    case vr::Prop_DisplayGCBlackClamp_Float:
-    case vr::Prop_DisplayGCOffset_Float:
-    case vr::Prop_DisplayGCScale_Float:
-    case vr::Prop_DisplayGCPrescale_Float:
-    case vr::Prop_LensCenterLeftU_Float:
-    case vr::Prop_LensCenterLeftV_Float:
-    case vr::Prop_LensCenterRightU_Float:
-    case vr::Prop_LensCenterRightV_Float:
-    case vr::Prop_UserHeadToEyeDepthMeters_Float:
-    case vr::Prop_FieldOfViewLeftDegrees_Float:
-    case vr::Prop_FieldOfViewRightDegrees_Float:
-    case vr::Prop_FieldOfViewTopDegrees_Float:
-    case vr::Prop_FieldOfViewBottomDegrees_Float:
-    case vr::Prop_TrackingRangeMinimumMeters_Float:
-    case vr::Prop_TrackingRangeMaximumMeters_Float:
-    case vr::Prop_ScreenshotHorizontalFieldOfViewDegrees_Float:
-    case vr::Prop_ScreenshotVerticalFieldOfViewDegrees_Float:
-    // Uint64
-    case vr::Prop_HardwareRevision_Uint64:
-    case vr::Prop_FirmwareVersion_Uint64:
-    case vr::Prop_FPGAVersion_Uint64:
-    case vr::Prop_VRCVersion_Uint64:
-    case vr::Prop_RadioVersion_Uint64:
-    case vr::Prop_DongleVersion_Uint64:
-    case vr::Prop_CurrentUniverseId_Uint64:
-    case vr::Prop_PreviousUniverseId_Uint64:
-    case vr::Prop_DisplayFirmwareVersion_Uint64:
-    case vr::Prop_CameraFirmwareVersion_Uint64:
-    case vr::Prop_DisplayFPGAVersion_Uint64:
-    case vr::Prop_DisplayBootloaderVersion_Uint64:
-    case vr::Prop_DisplayHardwareVersion_Uint64:
-    case vr::Prop_AudioFirmwareVersion_Uint64:
-    case vr::Prop_SupportedButtons_Uint64:
-    // String
-    case vr::Prop_TrackingSystemName_String:
-    case vr::Prop_ModelNumber_String:
-    case vr::Prop_SerialNumber_String:
-    case vr::Prop_RenderModelName_String:
-    case vr::Prop_ManufacturerName_String:
-    case vr::Prop_TrackingFirmwareVersion_String:
-    case vr::Prop_HardwareRevision_String:
-    case vr::Prop_AllWirelessDongleDescriptions_String:
-    case vr::Prop_ConnectedWirelessDongle_String:
-    case vr::Prop_Firmware_ManualUpdateURL_String:
-    case vr::Prop_Firmware_ProgrammingTarget_String:
-    case vr::Prop_DisplayMCImageLeft_String:
-    case vr::Prop_DisplayMCImageRight_String:
-    case vr::Prop_DisplayGCImage_String:
-    case vr::Prop_CameraFirmwareDescription_String:
-    case vr::Prop_AttachedDeviceId_String:
-    case vr::Prop_ModeLabel_String:
-    case vr::Prop_DriverVersion_String:
-    // Matrix34
-    case vr::Prop_StatusDisplayTransform_Matrix34:
-    case vr::Prop_CameraToHeadTransform_Matrix34:
-        return true;
-    }
+/** \name Mapping between PropertyType and C++ types. */
+//@{
+template <PropertyType Type>
+struct PropertyValueType;
 
-    return true;
-}
+template <> struct PropertyValueType<PropertyType::Bool> { typedef bool type; };
+template <> struct PropertyValueType<PropertyType::Float> { typedef float type; };
+template <> struct PropertyValueType<PropertyType::Int32> { typedef int32_t type; };
+template <> struct PropertyValueType<PropertyType::Uint64> { typedef uint64_t type; };
+template <> struct PropertyValueType<PropertyType::String> { typedef std::string type; };
+template <> struct PropertyValueType<PropertyType::Matrix34> { typedef vr::HmdMatrix34_t type; };
 
-inline bool isWrongDataType(vr::ETrackedDeviceProperty prop, const uint64_t&)
-{
-    switch (prop) {
-    case vr::Prop_HardwareRevision_Uint64:
-    case vr::Prop_FirmwareVersion_Uint64:
-    case vr::Prop_FPGAVersion_Uint64:
-    case vr::Prop_VRCVersion_Uint64:
-    case vr::Prop_RadioVersion_Uint64:
-    case vr::Prop_DongleVersion_Uint64:
-    case vr::Prop_CurrentUniverseId_Uint64:
-    case vr::Prop_PreviousUniverseId_Uint64:
-    case vr::Prop_DisplayFirmwareVersion_Uint64:
-    case vr::Prop_CameraFirmwareVersion_Uint64:
-    case vr::Prop_DisplayFPGAVersion_Uint64:
-    case vr::Prop_DisplayBootloaderVersion_Uint64:
-    case vr::Prop_DisplayHardwareVersion_Uint64:
-    case vr::Prop_AudioFirmwareVersion_Uint64:
-    case vr::Prop_SupportedButtons_Uint64:
-    // could be any type
-    case vr::Prop_VendorSpecific_Reserved_Start:
-    case vr::Prop_VendorSpecific_Reserved_End:
-        return false;
-    // Bool
-    case vr::Prop_WillDriftInYaw_Bool:
-    case vr::Prop_DeviceIsWireless_Bool:
-    case vr::Prop_DeviceIsCharging_Bool:
-    case vr::Prop_Firmware_UpdateAvailable_Bool:
-    case vr::Prop_Firmware_ManualUpdate_Bool:
-    case vr::Prop_BlockServerShutdown_Bool:
-    case vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool:
-    case vr::Prop_ContainsProximitySensor_Bool:
-    case vr::Prop_DeviceProvidesBatteryStatus_Bool:
-    case vr::Prop_DeviceCanPowerOff_Bool:
-    case vr::Prop_HasCamera_Bool:
-    case vr::Prop_ReportsTimeSinceVSync_Bool:
-    case vr::Prop_IsOnDesktop_Bool:
-    case vr::Prop_Firmware_ForceUpdateRequired_Bool:
-    case vr::Prop_DisplaySuppressed_Bool:
-    // Float
-    case vr::Prop_DeviceBatteryPercentage_Float:
-    case vr::Prop_SecondsFromVsyncToPhotons_Float:
-    case vr::Prop_DisplayFrequency_Float:
-    case vr::Prop_UserIpdMeters_Float:
-    case vr::Prop_DisplayMCOffset_Float:
-    case vr::Prop_DisplayMCScale_Float:
-    case vr::Prop_DisplayGCBlackClamp_Float:
-    case vr::Prop_DisplayGCOffset_Float:
-    case vr::Prop_DisplayGCScale_Float:
-    case vr::Prop_DisplayGCPrescale_Float:
-    case vr::Prop_LensCenterLeftU_Float:
-    case vr::Prop_LensCenterLeftV_Float:
-    case vr::Prop_LensCenterRightU_Float:
-    case vr::Prop_LensCenterRightV_Float:
-    case vr::Prop_UserHeadToEyeDepthMeters_Float:
-    case vr::Prop_FieldOfViewLeftDegrees_Float:
-    case vr::Prop_FieldOfViewRightDegrees_Float:
-    case vr::Prop_FieldOfViewTopDegrees_Float:
-    case vr::Prop_FieldOfViewBottomDegrees_Float:
-    case vr::Prop_TrackingRangeMinimumMeters_Float:
-    case vr::Prop_TrackingRangeMaximumMeters_Float:
-    case vr::Prop_ScreenshotHorizontalFieldOfViewDegrees_Float:
-    case vr::Prop_ScreenshotVerticalFieldOfViewDegrees_Float:
-    // Int32
-    case vr::Prop_DeviceClass_Int32:
-    case vr::Prop_DisplayMCType_Int32:
-    case vr::Prop_EdidVendorID_Int32:
-    case vr::Prop_EdidProductID_Int32:
-    case vr::Prop_DisplayGCType_Int32:
-    case vr::Prop_Axis0Type_Int32:
-    case vr::Prop_Axis1Type_Int32:
-    case vr::Prop_Axis2Type_Int32:
-    case vr::Prop_Axis3Type_Int32:
-    case vr::Prop_Axis4Type_Int32:
-    case vr::Prop_CameraCompatibilityMode_Int32:
-    // String
-    case vr::Prop_TrackingSystemName_String:
-    case vr::Prop_ModelNumber_String:
-    case vr::Prop_SerialNumber_String:
-    case vr::Prop_RenderModelName_String:
-    case vr::Prop_ManufacturerName_String:
-    case vr::Prop_TrackingFirmwareVersion_String:
-    case vr::Prop_HardwareRevision_String:
-    case vr::Prop_AllWirelessDongleDescriptions_String:
-    case vr::Prop_ConnectedWirelessDongle_String:
-    case vr::Prop_Firmware_ManualUpdateURL_String:
-    case vr::Prop_Firmware_ProgrammingTarget_String:
-    case vr::Prop_DisplayMCImageLeft_String:
-    case vr::Prop_DisplayMCImageRight_String:
-    case vr::Prop_DisplayGCImage_String:
-    case vr::Prop_CameraFirmwareDescription_String:
-    case vr::Prop_AttachedDeviceId_String:
-    case vr::Prop_ModeLabel_String:
-    case vr::Prop_DriverVersion_String:
-    // Matrix34
-    case vr::Prop_StatusDisplayTransform_Matrix34:
-    case vr::Prop_CameraToHeadTransform_Matrix34:
-        return true;
-    }
+template <typename T>
+struct PropertyTypeOf;
 
-    return true;
-}
+template <> struct PropertyTypeOf<bool> : std::integral_constant<PropertyType, PropertyType::Bool> {};
+template <> struct PropertyTypeOf<float> : std::integral_constant<PropertyType, PropertyType::Float> {};
+template <> struct PropertyTypeOf<int32_t> : std::integral_constant<PropertyType, PropertyType::Int32> {};
+template <> struct PropertyTypeOf<uint64_t> : std::integral_constant<PropertyType, PropertyType::Uint64> {};
+template <> struct PropertyTypeOf<std::string> : std::integral_constant<PropertyType, PropertyType::String> {};
+template <> struct PropertyTypeOf<char*> : std::integral_constant<PropertyType, PropertyType::String> {};
+template <> struct PropertyTypeOf<const char*> : std::integral_constant<PropertyType, PropertyType::String> {};
+template <> struct PropertyTypeOf<vr::HmdMatrix34_t> : std::integral_constant<PropertyType, PropertyType::Matrix34> {};
+//@}
+
+/**
+ * Whether a value of type @p T may be stored in a property of type @p Type.
+ * Integers and enums may be stored in either integer type; string literals
+ * may be stored in string properties.
+ */
+template <PropertyType Type, typename T>
+struct IsPropertyValue : std::false_type {};
+
+template <typename T>
+struct IsPropertyValue<PropertyType::Bool, T> : std::is_same<T, bool> {};
+
+template <typename T>
+struct IsPropertyValue<PropertyType::Float, T> : std::is_floating_point<T> {};
+
+template <typename T>
+struct IsPropertyValue<PropertyType::Int32, T> : std::integral_constant<bool, (std::is_integral<T>::value && !std::is_same<T, bool>::value) || std::is_enum<T>::value> {};
 
-inline bool isWrongDataType(vr::ETrackedDeviceProperty prop, const char*)
+template <typename T>
+struct IsPropertyValue<PropertyType::Uint64, T> : IsPropertyValue<PropertyType::Int32, T> {};
+
+template <typename T>
+struct IsPropertyValue<PropertyType::String, T> : std::is_convertible<const T&, std::string> {};
+
+template <typename T>
+struct IsPropertyValue<PropertyType::Matrix34, T> : std::is_same<T, vr::HmdMatrix34_t> {};
+
+/**
+ * Compile-time metadata for each property. Using a property missing from
+ * OSVR_TRACKED_DEVICE_PROPERTIES is a compile error.
+ */
+template <vr::ETrackedDeviceProperty Prop>
+struct PropertyTraits;
+
+#define OSVR_PROPERTY_TRAITS(PROP, TYPE, OWNER) \
+    template <> \
+    struct PropertyTraits<vr::PROP> { \
+        static const PropertyType type = PropertyType::TYPE; \
+        static const PropertyOwner owner = PropertyOwner::OWNER; \
+        typedef PropertyValueType<PropertyType::TYPE>::type value_type; \
+    };
+OSVR_TRACKED_DEVICE_PROPERTIES(OSVR_PROPERTY_TRAITS)
+#undef OSVR_PROPERTY_TRAITS
+
+namespace detail {
+
+/**
+ * OpenVR numbers properties by the thousand. The table has one row per
+ * thousand, each as wide as the longest group.
+ */
+static const std::size_t PROPERTY_GROUP_SIZE = 1000;
+
+constexpr std::size_t larger(std::size_t a, std::size_t b)
 {
-    switch (prop) {
-    case vr::Prop_TrackingSystemName_String:
-    case vr::Prop_ModelNumber_String:
-    case vr::Prop_SerialNumber_String:
-    case vr::Prop_RenderModelName_String:
-    case vr::Prop_ManufacturerName_String:
-    case vr::Prop_TrackingFirmwareVersion_String:
-    case vr::Prop_HardwareRevision_String:
-    case vr::Prop_AllWirelessDongleDescriptions_String:
-    case vr::Prop_ConnectedWirelessDongle_String:
-    case vr::Prop_Firmware_ManualUpdateURL_String:
-    case vr::Prop_Firmware_ProgrammingTarget_String:
-    case vr::Prop_DisplayMCImageLeft_String:
-    case vr::Prop_DisplayMCImageRight_String:
-    case vr::Prop_DisplayGCImage_String:
-    case vr::Prop_CameraFirmwareDescription_String:
-    case vr::Prop_AttachedDeviceId_String:
-    case vr::Prop_ModeLabel_String:
-    case vr::Prop_DriverVersion_String:
-    // could be any type
-    case vr::Prop_VendorSpecific_Reserved_Start:
-    case vr::Prop_VendorSpecific_Reserved_End:
-        return false;
-    // Bool
-    case vr::Prop_WillDriftInYaw_Bool:
-    case vr::Prop_DeviceIsWireless_Bool:
-    case vr::Prop_DeviceIsCharging_Bool:
-    case vr::Prop_Firmware_UpdateAvailable_Bool:
-    case vr::Prop_Firmware_ManualUpdate_Bool:
-    case vr::Prop_BlockServerShutdown_Bool:
-    case vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool:
-    case vr::Prop_ContainsProximitySensor_Bool:
-    case vr::Prop_DeviceProvidesBatteryStatus_Bool:
-    case vr::Prop_DeviceCanPowerOff_Bool:
-    case vr::Prop_HasCamera_Bool:
-    case vr::Prop_ReportsTimeSinceVSync_Bool:
-    case vr::Prop_IsOnDesktop_Bool:
-    case vr::Prop_Firmware_ForceUpdateRequired_Bool:
-    case vr::Prop_DisplaySuppressed_Bool:
-    // Float
-    case vr::Prop_DeviceBatteryPercentage_Float:
-    case vr::Prop_SecondsFromVsyncToPhotons_Float:
-    case vr::Prop_DisplayFrequency_Float:
-    case vr::Prop_UserIpdMeters_Float:
-    case vr::Prop_DisplayMCOffset_Float:
-    case vr::Prop_DisplayMCScale_Float:
-    case vr::Prop_DisplayGCBlackClamp_Float:
-    case vr::Prop_DisplayGCOffset_Float:
-    case vr::Prop_DisplayGCScale_Float:
-    case vr::Prop_DisplayGCPrescale_Float:
-    case vr::Prop_LensCenterLeftU_Float:
-    case vr::Prop_LensCenterLeftV_Float:
-    case vr::Prop_LensCenterRightU_Float:
-    case vr::Prop_LensCenterRightV_Float:
-    case vr::Prop_UserHeadToEyeDepthMeters_Float:
-    case vr::Prop_FieldOfViewLeftDegrees_Float:
-    case vr::Prop_FieldOfViewRightDegrees_Float:
-    case vr::Prop_FieldOfViewTopDegrees_Float:
-    case vr::Prop_FieldOfViewBottomDegrees_Float:
-    case vr::Prop_TrackingRangeMinimumMeters_Float:
-    case vr::Prop_TrackingRangeMaximumMeters_Float:
-    case vr::Prop_ScreenshotHorizontalFieldOfViewDegrees_Float:
-    case vr::Prop_ScreenshotVerticalFieldOfViewDegrees_Float:
-    // Int32
-    case vr::Prop_DeviceClass_Int32:
-    case vr::Prop_DisplayMCType_Int32:
-    case vr::Prop_EdidVendorID_Int32:
-    case vr::Prop_EdidProductID_Int32:
-    case vr::Prop_DisplayGCType_Int32:
-    case vr::Prop_Axis0Type_Int32:
-    case vr::Prop_Axis1Type_Int32:
-    case vr::Prop_Axis2Type_Int32:
-    case vr::Prop_Axis3Type_Int32:
-    case vr::Prop_Axis4Type_Int32:
-    case vr::Prop_CameraCompatibilityMode_Int32:
-    // Uint64
-    case vr::Prop_HardwareRevision_Uint64:
-    case vr::Prop_FirmwareVersion_Uint64:
-    case vr::Prop_FPGAVersion_Uint64:
-    case vr::Prop_VRCVersion_Uint64:
-    case vr::Prop_RadioVersion_Uint64:
-    case vr::Prop_DongleVersion_Uint64:
-    case vr::Prop_CurrentUniverseId_Uint64:
-    case vr::Prop_PreviousUniverseId_Uint64:
-    case vr::Prop_DisplayFirmwareVersion_Uint64:
-    case vr::Prop_CameraFirmwareVersion_Uint64:
-    case vr::Prop_DisplayFPGAVersion_Uint64:
-    case vr::Prop_DisplayBootloaderVersion_Uint64:
-    case vr::Prop_DisplayHardwareVersion_Uint64:
-    case vr::Prop_AudioFirmwareVersion_Uint64:
-    case vr::Prop_SupportedButtons_Uint64:
-    // Matrix34
-    case vr::Prop_StatusDisplayTransform_Matrix34:
-    case vr::Prop_CameraToHeadTransform_Matrix34:
-        return true;
-    }
+    return (a > b) ? a : b;
+}
 
-    return true;
+#define OSVR_PROPERTY_GROUP(PROP, TYPE, OWNER) larger(static_cast<std::size_t>(vr::PROP) / PROPERTY_GROUP_SIZE,
+#define OSVR_PROPERTY_OFFSET(PROP, TYPE, OWNER) larger(static_cast<std::size_t>(vr::PROP) % PROPERTY_GROUP_SIZE,
+#define OSVR_CLOSE_PAREN(PROP, TYPE, OWNER) )
+
+static const std::size_t PROPERTY_TABLE_ROWS = OSVR_TRACKED_DEVICE_PROPERTIES(OSVR_PROPERTY_GROUP) 0 OSVR_TRACKED_DEVICE_PROPERTIES(OSVR_CLOSE_PAREN) + 1;
+static const std::size_t PROPERTY_TABLE_COLUMNS = OSVR_TRACKED_DEVICE_PROPERTIES(OSVR_PROPERTY_OFFSET) 0 OSVR_TRACKED_DEVICE_PROPERTIES(OSVR_CLOSE_PAREN) + 1;
+
+#undef OSVR_PROPERTY_GROUP
+#undef OSVR_PROPERTY_OFFSET
+#undef OSVR_CLOSE_PAREN
+
+/**
+ * Looks up the metadata for the property with the given ID. Only evaluated
+ * at compile time, to fill in PropertyTable.
+ */
+constexpr PropertyInfo findPropertyInfo(std::size_t id)
+{
+#define OSVR_PROPERTY_INFO(PROP, TYPE, OWNER) (static_cast<std::size_t>(vr::PROP) == id) ? PropertyInfo{PropertyType::TYPE, PropertyOwner::OWNER} :
+    return OSVR_TRACKED_DEVICE_PROPERTIES(OSVR_PROPERTY_INFO) PropertyInfo{PropertyType::None, PropertyOwner::None};
+#undef OSVR_PROPERTY_INFO
 }
 
-inline bool isWrongDataType(vr::ETrackedDeviceProperty prop, std::string)
+constexpr PropertyInfo findPropertyInfoAt(std::size_t index)
 {
-    return isWrongDataType(prop, "");
+    return findPropertyInfo((index / PROPERTY_TABLE_COLUMNS) * PROPERTY_GROUP_SIZE + index % PROPERTY_TABLE_COLUMNS);
 }
 
-inline bool isWrongDataType(vr::ETrackedDeviceProperty prop, vr::HmdMatrix34_t)
+template <std::size_t... I>
+struct IndexSequence {};
+
+template <std::size_t N, std::size_t... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> {};
+
+template <std::size_t... I>
+struct MakeIndexSequence<0, I...> {
+    typedef IndexSequence<I...> type;
+};
+
+template <typename Indices>
+struct PropertyTableImpl;
+
+template <std::size_t... I>
+struct PropertyTableImpl<IndexSequence<I...>> {
+    static constexpr PropertyInfo entries[sizeof...(I)] = { findPropertyInfoAt(I)... };
+};
+
+template <std::size_t... I>
+constexpr PropertyInfo PropertyTableImpl<IndexSequence<I...>>::entries[sizeof...(I)];
+
+typedef PropertyTableImpl<MakeIndexSequence<PROPERTY_TABLE_ROWS * PROPERTY_TABLE_COLUMNS>::type> PropertyTable;
+
+} // namespace detail
+
+/**
+ * Returns the type and device class of @p prop with a single indexed load.
+ */
+inline PropertyInfo getPropertyInfo(vr::ETrackedDeviceProperty prop)
 {
-    switch (prop) {
-    case vr::Prop_StatusDisplayTransform_Matrix34:
-    case vr::Prop_CameraToHeadTransform_Matrix34:
-    // could be any type
-    case vr::Prop_VendorSpecific_Reserved_Start:
-    case vr::Prop_VendorSpecific_Reserved_End:
-        return false;
-    // Bool
-    case vr::Prop_WillDriftInYaw_Bool:
-    case vr::Prop_DeviceIsWireless_Bool:
-    case vr::Prop_DeviceIsCharging_Bool:
-    case vr::Prop_Firmware_UpdateAvailable_Bool:
-    case vr::Prop_Firmware_ManualUpdate_Bool:
-    case vr::Prop_BlockServerShutdown_Bool:
-    case vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool:
-    case vr::Prop_ContainsProximitySensor_Bool:
-    case vr::Prop_DeviceProvidesBatteryStatus_Bool:
-    case vr::Prop_DeviceCanPowerOff_Bool:
-    case vr::Prop_HasCamera_Bool:
-    case vr::Prop_ReportsTimeSinceVSync_Bool:
-    case vr::Prop_IsOnDesktop_Bool:
-    case vr::Prop_Firmware_ForceUpdateRequired_Bool:
-    case vr::Prop_DisplaySuppressed_Bool:
-    // Float
-    case vr::Prop_DeviceBatteryPercentage_Float:
-    case vr::Prop_SecondsFromVsyncToPhotons_Float:
-    case vr::Prop_DisplayFrequency_Float:
-    case vr::Prop_UserIpdMeters_Float:
-    case vr::Prop_DisplayMCOffset_Float:
-    case vr::Prop_DisplayMCScale_Float:
-    case vr::Prop_DisplayGCBlackClamp_Float:
-    case vr::Prop_DisplayGCOffset_Float:
-    case vr::Prop_DisplayGCScale_Float:
-    case vr::Prop_DisplayGCPrescale_Float:
-    case vr::Prop_LensCenterLeftU_Float:
-    case vr::Prop_LensCenterLeftV_Float:
-    case vr::Prop_LensCenterRightU_Float:
-    case vr::Prop_LensCenterRightV_Float:
-    case vr::Prop_UserHeadToEyeDepthMeters_Float:
-    case vr::Prop_FieldOfViewLeftDegrees_Float:
-    case vr::Prop_FieldOfViewRightDegrees_Float:
-    case vr::Prop_FieldOfViewTopDegrees_Float:
-    case vr::Prop_FieldOfViewBottomDegrees_Float:
-    case vr::Prop_TrackingRangeMinimumMeters_Float:
-    case vr::Prop_TrackingRangeMaximumMeters_Float:
-    case vr::Prop_ScreenshotHorizontalFieldOfViewDegrees_Float:
-    case vr::Prop_ScreenshotVerticalFieldOfViewDegrees_Float:
-    // Int32
-    case vr::Prop_DeviceClass_Int32:
-    case vr::Prop_DisplayMCType_Int32:
-    case vr::Prop_EdidVendorID_Int32:
-    case vr::Prop_EdidProductID_Int32:
-    case vr::Prop_DisplayGCType_Int32:
-    case vr::Prop_Axis0Type_Int32:
-    case vr::Prop_Axis1Type_Int32:
-    case vr::Prop_Axis2Type_Int32:
-    case vr::Prop_Axis3Type_Int32:
-    case vr::Prop_Axis4Type_Int32:
-    case vr::Prop_CameraCompatibilityMode_Int32:
-    // Uint64
-    case vr::Prop_HardwareRevision_Uint64:
-    case vr::Prop_FirmwareVersion_Uint64:
-    case vr::Prop_FPGAVersion_Uint64:
-    case vr::Prop_VRCVersion_Uint64:
-    case vr::Prop_RadioVersion_Uint64:
-    case vr::Prop_DongleVersion_Uint64:
-    case vr::Prop_CurrentUniverseId_Uint64:
-    case vr::Prop_PreviousUniverseId_Uint64:
-    case vr::Prop_DisplayFirmwareVersion_Uint64:
-    case vr::Prop_CameraFirmwareVersion_Uint64:
-    case vr::Prop_DisplayFPGAVersion_Uint64:
-    case vr::Prop_DisplayBootloaderVersion_Uint64:
-    case vr::Prop_DisplayHardwareVersion_Uint64:
-    case vr::Prop_AudioFirmwareVersion_Uint64:
-    case vr::Prop_SupportedButtons_Uint64:
-    // String
-    case vr::Prop_TrackingSystemName_String:
-    case vr::Prop_ModelNumber_String:
-    case vr::Prop_SerialNumber_String:
-    case vr::Prop_RenderModelName_String:
-    case vr::Prop_ManufacturerName_String:
-    case vr::Prop_TrackingFirmwareVersion_String:
-    case vr::Prop_HardwareRevision_String:
-    case vr::Prop_AllWirelessDongleDescriptions_String:
-    case vr::Prop_ConnectedWirelessDongle_String:
-    case vr::Prop_Firmware_ManualUpdateURL_String:
-    case vr::Prop_Firmware_ProgrammingTarget_String:
-    case vr::Prop_DisplayMCImageLeft_String:
-    case vr::Prop_DisplayMCImageRight_String:
-    case vr::Prop_DisplayGCImage_String:
-    case vr::Prop_CameraFirmwareDescription_String:
-    case vr::Prop_AttachedDeviceId_String:
-    case vr::Prop_ModeLabel_String:
-    case vr::Prop_DriverVersion_String:
-        return true;
-    }
+    // Vendors are free to expose private debug data in this reserved region
+    if (prop >= vr::Prop_VendorSpecific_Reserved_Start && prop <= vr::Prop_VendorSpecific_Reserved_End)
+        return PropertyInfo{PropertyType::Any, PropertyOwner::None};
 
-    return true;
+    const auto id = static_cast<std::size_t>(prop);
+    const auto row = id / detail::PROPERTY_GROUP_SIZE;
+    const auto column = id % detail::PROPERTY_GROUP_SIZE;
+    if (row >= detail::PROPERTY_TABLE_ROWS || column >= detail::PROPERTY_TABLE_COLUMNS)
+        return PropertyInfo{PropertyType::None, PropertyOwner::None};
+
+    return detail::PropertyTable::entries[row * detail::PROPERTY_TABLE_COLUMNS + column];
 }
 
-inline bool isWrongDeviceClass(vr::ETrackedDeviceProperty prop, vr::ETrackedDeviceClass device_class)
+inline bool isWrongDataType(const PropertyInfo& info, PropertyType type)
 {
-    switch (prop) {
-    // General properties that apply to all device classes
-    case vr::Prop_TrackingSystemName_String:
-    case vr::Prop_ModelNumber_String:
-    case vr::Prop_SerialNumber_String:
-    case vr::Prop_RenderModelName_String:
-    case vr::Prop_WillDriftInYaw_Bool:
-    case vr::Prop_ManufacturerName_String:
-    case vr::Prop_TrackingFirmwareVersion_String:
-    case vr::Prop_HardwareRevision_String:
-    case vr::Prop_AllWirelessDongleDescriptions_String:
-    case vr::Prop_ConnectedWirelessDongle_String:
-    case vr::Prop_DeviceIsWireless_Bool:
-    case vr::Prop_DeviceIsCharging_Bool:
-    case vr::Prop_DeviceBatteryPercentage_Float:
-    case vr::Prop_StatusDisplayTransform_Matrix34:
-    case vr::Prop_Firmware_UpdateAvailable_Bool:
-    case vr::Prop_Firmware_ManualUpdate_Bool:
-    case vr::Prop_Firmware_ManualUpdateURL_String:
-    case vr::Prop_HardwareRevision_Uint64:
-    case vr::Prop_FirmwareVersion_Uint64:
-    case vr::Prop_FPGAVersion_Uint64:
-    case vr::Prop_VRCVersion_Uint64:
-    case vr::Prop_RadioVersion_Uint64:
-    case vr::Prop_DongleVersion_Uint64:
-    case vr::Prop_BlockServerShutdown_Bool:
-    case vr::Prop_CanUnifyCoordinateSystemWithHmd_Bool:
-    case vr::Prop_ContainsProximitySensor_Bool:
-    case vr::Prop_DeviceProvidesBatteryStatus_Bool:
-    case vr::Prop_DeviceCanPowerOff_Bool:
-    case vr::Prop_Firmware_ProgrammingTarget_String:
-    case vr::Prop_DeviceClass_Int32:
-    case vr::Prop_HasCamera_Bool:
-    case vr::Prop_Firmware_ForceUpdateRequired_Bool:
-    case vr::Prop_DriverVersion_String:
-        return false;
+    return (PropertyType::Any != info.type) && (type != info.type);
+}
 
-    // Properties that are unique to TrackedDeviceClass_HMD
-    case vr::Prop_ReportsTimeSinceVSync_Bool:
-    case vr::Prop_SecondsFromVsyncToPhotons_Float:
-    case vr::Prop_DisplayFrequency_Float:
-    case vr::Prop_UserIpdMeters_Float:
-    case vr::Prop_CurrentUniverseId_Uint64:
-    case vr::Prop_PreviousUniverseId_Uint64:
-    case vr::Prop_DisplayFirmwareVersion_Uint64:
-    case vr::Prop_IsOnDesktop_Bool:
-    case vr::Prop_DisplayMCType_Int32:
-    case vr::Prop_DisplayMCOffset_Float:
-    case vr::Prop_DisplayMCScale_Float:
-    case vr::Prop_EdidVendorID_Int32:
-    case vr::Prop_DisplayMCImageLeft_String:
-    case vr::Prop_DisplayMCImageRight_String:
-    case vr::Prop_DisplayGCBlackClamp_Float:
-    case vr::Prop_EdidProductID_Int32:
-    case vr::Prop_CameraToHeadTransform_Matrix34:
-    case vr::Prop_DisplayGCType_Int32:
-    case vr::Prop_DisplayGCOffset_Float:
-    case vr::Prop_DisplayGCScale_Float:
-    case vr::Prop_DisplayGCPrescale_Float:
-    case vr::Prop_DisplayGCImage_String:
-    case vr::Prop_LensCenterLeftU_Float:
-    case vr::Prop_LensCenterLeftV_Float:
-    case vr::Prop_LensCenterRightU_Float:
-    case vr::Prop_LensCenterRightV_Float:
-    case vr::Prop_UserHeadToEyeDepthMeters_Float:
-    case vr::Prop_CameraFirmwareVersion_Uint64:
-    case vr::Prop_CameraFirmwareDescription_String:
-    case vr::Prop_DisplayFPGAVersion_Uint64:
-    case vr::Prop_DisplayBootloaderVersion_Uint64:
-    case vr::Prop_DisplayHardwareVersion_Uint64:
-    case vr::Prop_AudioFirmwareVersion_Uint64:
-    case vr::Prop_CameraCompatibilityMode_Int32:
-    case vr::Prop_ScreenshotHorizontalFieldOfViewDegrees_Float:
-    case vr::Prop_ScreenshotVerticalFieldOfViewDegrees_Float:
-    case vr::Prop_DisplaySuppressed_Bool:
+inline bool isWrongDeviceClass(const PropertyInfo& info, vr::ETrackedDeviceClass device_class)
+{
+    switch (info.owner) {
+    case PropertyOwner::All:
+        return false;
+    case PropertyOwner::HMD:
         return (vr::TrackedDeviceClass_HMD != device_class);
-
-    // Properties that are unique to TrackedDeviceClass_Controller
-    case vr::Prop_AttachedDeviceId_String:
-    case vr::Prop_SupportedButtons_Uint64:
-    case vr::Prop_Axis0Type_Int32:
-    case vr::Prop_Axis1Type_Int32:
-    case vr::Prop_Axis2Type_Int32:
-    case vr::Prop_Axis3Type_Int32:
-    case vr::Prop_Axis4Type_Int32:
+    case PropertyOwner::Controller:
         return (vr::TrackedDeviceClass_Controller != device_class);
-
-    // Properties that are unique to TrackedDeviceClass_TrackingReference
-    case vr::Prop_FieldOfViewLeftDegrees_Float:
-    case vr::Prop_FieldOfViewRightDegrees_Float:
-    case vr::Prop_FieldOfViewTopDegrees_Float:
-    case vr::Prop_FieldOfViewBottomDegrees_Float:
-    case vr::Prop_TrackingRangeMinimumMeters_Float:
-    case vr::Prop_TrackingRangeMaximumMeters_Float:
-    case vr::Prop_ModeLabel_String:
+    case PropertyOwner::TrackingReference:
         return (vr::TrackedDeviceClass_TrackingReference != device_class);
-
-    // Vendors are free to expose private debug data in this reserved region
-    case vr::Prop_VendorSpecific_Reserved_Start:
-    case vr::Prop_VendorSpecific_Reserved_End:
+    case PropertyOwner::None:
         return true;
     }
 
     return true;
 }
 
-#endif // INCLUDED_PropertyProperties_h_GUID_5212DE9D_B211_4139_A140_45A578EFA47E
+template <typename T>
+inline bool isWrongDataType(vr::ETrackedDeviceProperty prop, const T&)
+{
+    return isWrongDataType(getPropertyInfo(prop), PropertyTypeOf<T>::value);
+}
 
+inline bool isWrongDeviceClass(vr::ETrackedDeviceProperty prop, vr::ETrackedDeviceClass device_class)
+{
+    return isWrongDeviceClass(getPropertyInfo(prop), device_class);
+}
+
+#endif // INCLUDED_PropertyProperties_h_GUID_5212DE9D_B211_4139_A140_45A578EFA47E
@@ -0,0 +1,379 @@
+/** @file
+    @brief Dense storage for tracked device property values.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_PropertyStore_h_GUID_F2A7C5D1_6E84_4B3A_9D20_8C1B4E7F5A63
+#define INCLUDED_PropertyStore_h_GUID_F2A7C5D1_6E84_4B3A_9D20_8C1B4E7F5A63
+
+// Internal Includes
+#include "PropertyProperties.h"
+#include "identity.h"
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Holds the property values of one tracked device.
+ *
+ * OpenVR groups property IDs by the thousand (general properties start at
+ * 1000, HMD properties at 2000, and so on), so values are kept in one dense
+ * array per thousand and found with two indexed loads. Each slot records the
+ * type of its value; strings and matrices live in side tables so that slots
+ * stay small and references to them stay valid when other properties are
+ * added.
+ *
+ * Properties that are expensive to compute can be given a provider instead
+ * of a value. The provider runs the first time the property is read and its
+ * result is kept until the property is invalidated.
+ *
+ * Not thread-safe: even get() runs providers and updates the statistics. A
+ * device only uses its store from the SteamVR driver thread (property
+ * queries, RunFrame() and debug requests), so providers must not rely on
+ * being called anywhere else.
+ */
+class PropertyStore {
+public:
+    /**
+     * Sets a property, checking at compile time that @p value suits the
+     * property's type, and stores it as exactly that type.
+     */
+    template <vr::ETrackedDeviceProperty Prop, typename T>
+    void set(const T& value);
+
+    /** \name Setters for each type of property value. */
+    //@{
+    void set(vr::ETrackedDeviceProperty prop, bool value);
+    void set(vr::ETrackedDeviceProperty prop, float value);
+    void set(vr::ETrackedDeviceProperty prop, double value);
+    void set(vr::ETrackedDeviceProperty prop, int32_t value);
+    void set(vr::ETrackedDeviceProperty prop, const vr::HmdMatrix34_t& value);
+    void set(vr::ETrackedDeviceProperty prop, const std::string& value);
+    void set(vr::ETrackedDeviceProperty prop, const char* value);
+
+    /**
+     * Stores other signed integers as int32_t and unsigned integers as
+     * uint64_t, the only integer property types.
+     */
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type set(vr::ETrackedDeviceProperty prop, T value);
+    //@}
+
+    /**
+     * Computes @p Prop by calling @p provider when it is next read, and keeps
+     * the result until invalidate() is called for it.
+     */
+    template <vr::ETrackedDeviceProperty Prop, typename Function>
+    void setProvider(Function provider);
+
+    /**
+     * Makes the provider of @p prop run again the next time it is read. Has
+     * no effect on properties without a provider.
+     */
+    void invalidate(vr::ETrackedDeviceProperty prop);
+
+    /**
+     * Returns a pointer to the value of @p prop, or @c nullptr if it hasn't
+     * been set or holds a different type. Runs the property's provider if
+     * its value is out of date.
+     *
+     * @tparam T bool, float, int32_t, uint64_t, vr::HmdMatrix34_t, or
+     *     std::string
+     */
+    template <typename T>
+    const T* get(vr::ETrackedDeviceProperty prop);
+
+    /**
+     * Returns @c true if @p prop has been set.
+     */
+    bool contains(vr::ETrackedDeviceProperty prop) const;
+
+    /** \name Provider statistics */
+    //@{
+    uint64_t getHits() const;       ///< reads of provided properties answered from the cache
+    uint64_t getRecomputes() const; ///< provider calls
+    //@}
+
+private:
+    typedef PropertyType Type;
+
+    static const uint16_t NO_PROVIDER = 0xffff;
+
+    struct Slot {
+        Type type = Type::None;
+        bool stale = false;                 ///< provider must run before the value is read
+        uint16_t provider = NO_PROVIDER;    ///< into providers_
+        union {
+            bool boolValue;
+            float floatValue;
+            int32_t int32Value;
+            uint64_t uint64Value;
+            std::size_t index; ///< into matrices_ or strings_
+        };
+
+        Slot() : uint64Value(0) {}
+    };
+
+    static const std::size_t BUCKET_SIZE = 1000;
+    static const std::size_t NUM_BUCKETS = vr::Prop_VendorSpecific_Reserved_End / BUCKET_SIZE + 1;
+
+    /**
+     * Returns the slot for @p prop, or @c nullptr if it has never been set.
+     */
+    const Slot* find(vr::ETrackedDeviceProperty prop) const;
+    Slot* find(vr::ETrackedDeviceProperty prop);
+
+    /**
+     * Returns the slot for @p prop, growing its bucket as needed.
+     */
+    Slot& slot(vr::ETrackedDeviceProperty prop);
+
+    const bool* load(const Slot& slot, identity<bool>) const;
+    const float* load(const Slot& slot, identity<float>) const;
+    const int32_t* load(const Slot& slot, identity<int32_t>) const;
+    const uint64_t* load(const Slot& slot, identity<uint64_t>) const;
+    const vr::HmdMatrix34_t* load(const Slot& slot, identity<vr::HmdMatrix34_t>) const;
+    const std::string* load(const Slot& slot, identity<std::string>) const;
+
+    std::vector<Slot> buckets_[NUM_BUCKETS];
+    std::deque<vr::HmdMatrix34_t> matrices_;
+    std::deque<std::string> strings_;
+    std::vector<std::function<void(PropertyStore&)>> providers_;
+
+    uint64_t hits_ = 0;
+    uint64_t recomputes_ = 0;
+};
+
+template <vr::ETrackedDeviceProperty Prop, typename T>
+inline void PropertyStore::set(const T& value)
+{
+    typedef PropertyTraits<Prop> Traits;
+    static_assert(IsPropertyValue<Traits::type, T>::value, "The value doesn't match the type of the property.");
+    set(Prop, static_cast<typename Traits::value_type>(value));
+}
+
+inline void PropertyStore::set(vr::ETrackedDeviceProperty prop, bool value)
+{
+    auto& s = slot(prop);
+    s.type = Type::Bool;
+    s.boolValue = value;
+}
+
+inline void PropertyStore::set(vr::ETrackedDeviceProperty prop, float value)
+{
+    auto& s = slot(prop);
+    s.type = Type::Float;
+    s.floatValue = value;
+}
+
+inline void PropertyStore::set(vr::ETrackedDeviceProperty prop, double value)
+{
+    set(prop, static_cast<float>(value));
+}
+
+inline void PropertyStore::set(vr::ETrackedDeviceProperty prop, int32_t value)
+{
+    auto& s = slot(prop);
+    s.type = Type::Int32;
+    s.int32Value = value;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value>::type PropertyStore::set(vr::ETrackedDeviceProperty prop, T value)
+{
+    if (std::is_signed<T>::value) {
+        set(prop, static_cast<int32_t>(value));
+        return;
+    }
+
+    auto& s = slot(prop);
+    s.type = Type::Uint64;
+    s.uint64Value = static_cast<uint64_t>(value);
+}
+
+inline void PropertyStore::set(vr::ETrackedDeviceProperty prop, const vr::HmdMatrix34_t& value)
+{
+    auto& s = slot(prop);
+    if (Type::Matrix34 == s.type) {
+        matrices_[s.index] = value;
+        return;
+    }
+
+    s.type = Type::Matrix34;
+    s.index = matrices_.size();
+    matrices_.push_back(value);
+}
+
+inline void PropertyStore::set(vr::ETrackedDeviceProperty prop, const std::string& value)
+{
+    auto& s = slot(prop);
+    if (Type::String == s.type) {
+        strings_[s.index] = value;
+        return;
+    }
+
+    s.type = Type::String;
+    s.index = strings_.size();
+    strings_.push_back(value);
+}
+
+inline void PropertyStore::set(vr::ETrackedDeviceProperty prop, const char* value)
+{
+    set(prop, std::string(value ? value : ""));
+}
+
+template <vr::ETrackedDeviceProperty Prop, typename Function>
+inline void PropertyStore::setProvider(Function provider)
+{
+    auto update = [provider](PropertyStore& store) { store.set<Prop>(provider()); };
+
+    auto& s = slot(Prop);
+    if (NO_PROVIDER == s.provider) {
+        s.provider = static_cast<uint16_t>(providers_.size());
+        providers_.push_back(update);
+    } else {
+        providers_[s.provider] = update;
+    }
+    s.stale = true;
+}
+
+inline void PropertyStore::invalidate(vr::ETrackedDeviceProperty prop)
+{
+    auto s = find(prop);
+    if (s && NO_PROVIDER != s->provider) {
+        s->stale = true;
+    }
+}
+
+template <typename T>
+inline const T* PropertyStore::get(vr::ETrackedDeviceProperty prop)
+{
+    auto s = find(prop);
+    if (!s)
+        return nullptr;
+
+    if (NO_PROVIDER != s->provider) {
+        if (s->stale) {
+            providers_[s->provider](*this);
+            ++recomputes_;
+
+            // The provider may have set other properties and moved this slot
+            s = find(prop);
+            s->stale = false;
+        } else {
+            ++hits_;
+        }
+    }
+
+    return load(*s, identity<T>());
+}
+
+inline bool PropertyStore::contains(vr::ETrackedDeviceProperty prop) const
+{
+    const auto s = find(prop);
+    return s && (Type::None != s->type || NO_PROVIDER != s->provider);
+}
+
+inline uint64_t PropertyStore::getHits() const
+{
+    return hits_;
+}
+
+inline uint64_t PropertyStore::getRecomputes() const
+{
+    return recomputes_;
+}
+
+inline const PropertyStore::Slot* PropertyStore::find(vr::ETrackedDeviceProperty prop) const
+{
+    const auto id = static_cast<std::size_t>(prop);
+    const auto bucket = id / BUCKET_SIZE;
+    const auto offset = id % BUCKET_SIZE;
+    if (bucket >= NUM_BUCKETS || offset >= buckets_[bucket].size())
+        return nullptr;
+
+    return &buckets_[bucket][offset];
+}
+
+inline PropertyStore::Slot* PropertyStore::find(vr::ETrackedDeviceProperty prop)
+{
+    return const_cast<Slot*>(static_cast<const PropertyStore&>(*this).find(prop));
+}
+
+inline PropertyStore::Slot& PropertyStore::slot(vr::ETrackedDeviceProperty prop)
+{
+    const auto id = static_cast<std::size_t>(prop);
+    const auto bucket = id / BUCKET_SIZE;
+    const auto offset = id % BUCKET_SIZE;
+    if (bucket >= NUM_BUCKETS) {
+        throw std::out_of_range("Property " + std::to_string(id) + " is outside the range of OpenVR properties.");
+    }
+
+    auto& slots = buckets_[bucket];
+    if (offset >= slots.size()) {
+        slots.resize(offset + 1);
+    }
+
+    return slots[offset];
+}
+
+inline const bool* PropertyStore::load(const Slot& slot, identity<bool>) const
+{
+    return (Type::Bool == slot.type) ? &slot.boolValue : nullptr;
+}
+
+inline const float* PropertyStore::load(const Slot& slot, identity<float>) const
+{
+    return (Type::Float == slot.type) ? &slot.floatValue : nullptr;
+}
+
+inline const int32_t* PropertyStore::load(const Slot& slot, identity<int32_t>) const
+{
+    return (Type::Int32 == slot.type) ? &slot.int32Value : nullptr;
+}
+
+inline const uint64_t* PropertyStore::load(const Slot& slot, identity<uint64_t>) const
+{
+    return (Type::Uint64 == slot.type) ? &slot.uint64Value : nullptr;
+}
+
+inline const vr::HmdMatrix34_t* PropertyStore::load(const Slot& slot, identity<vr::HmdMatrix34_t>) const
+{
+    return (Type::Matrix34 == slot.type) ? &matrices_[slot.index] : nullptr;
+}
+
+inline const std::string* PropertyStore::load(const Slot& slot, identity<std::string>) const
+{
+    return (Type::String == slot.type) ? &strings_[slot.index] : nullptr;
+}
+
+#endif // INCLUDED_PropertyStore_h_GUID_F2A7C5D1_6E84_4B3A_9D20_8C1B4E7F5A63
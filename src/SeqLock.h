@@ -0,0 +1,129 @@
+/** @file
+    @brief Sequence lock for sharing small values between threads.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_SeqLock_h_GUID_5E2B9C71_A4D3_4F86_B10E_7C3D68F2E9A5
+#define INCLUDED_SeqLock_h_GUID_5E2B9C71_A4D3_4F86_B10E_7C3D68F2E9A5
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>      // for std::memcpy
+#include <type_traits>
+
+/**
+ * @brief Holds a trivially-copyable value that is written by one thread at a
+ * time and read by any number of threads.
+ *
+ * Writers never wait on readers. Readers retry until they copy the value
+ * without a write overlapping them, so load() always returns a consistent
+ * snapshot. The value is stored as atomic words so that the overlapping
+ * copies a reader throws away are not data races.
+ */
+template <typename T>
+class SeqLock {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially-copyable type.");
+
+    SeqLock()
+    {
+        store(T());
+    }
+
+    explicit SeqLock(const T& value)
+    {
+        store(value);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * Replaces the stored value. Concurrent writers are serialized, but
+     * writers never wait for readers.
+     */
+    void store(const T& value)
+    {
+        uint64_t words[WORD_COUNT] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        // Claim the lock by making the sequence odd
+        auto sequence = sequence_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (sequence & 1) {
+                sequence = sequence_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                break;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Returns a consistent copy of the stored value.
+     */
+    T load() const
+    {
+        uint64_t words[WORD_COUNT];
+        for (;;) {
+            const auto before = sequence_.load(std::memory_order_acquire);
+            if (before & 1)
+                continue;
+
+            for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before)
+                break;
+        }
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+private:
+    static const std::size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence_ { 0 };
+    std::atomic<uint64_t> words_[WORD_COUNT];
+};
+
+#endif // INCLUDED_SeqLock_h_GUID_5E2B9C71_A4D3_4F86_B10E_7C3D68F2E9A5
@@ -26,7 +26,9 @@
 #include "ServerDriver_OSVR.h"
 
 #include "OSVRTrackedHMD.h"         // for OSVRTrackedHMD
+#include "OSVRTrackedController.h"  // for OSVRTrackedController
 #include "OSVRTrackingReference.h"  // for OSVRTrackingReference
+#include "InterfacePaths.h"         // for getInterfacePaths
 #include "platform_fixes.h"         // strcasecmp
 #include "make_unique.h"            // for std::make_unique
 #include "osvr_platform.h"          // for OSVR_PATH_SEPARATOR
@@ -37,28 +39,118 @@
 
 #include <osvr/ClientKit/Context.h> // for osvr::clientkit::ClientContext
 
+#if defined(OSVR_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>                // for SetThreadPriority
+#else
+#include <pthread.h>                // for pthread_setschedparam
+#include <sched.h>                  // for sched_get_priority_max
+#endif
+
 // Standard includes
 #include <vector>                   // for std::vector
+#include <cctype>                   // for std::isdigit
 #include <cstring>                  // for std::strcmp
 #include <string>                   // for std::string
+#include <chrono>                   // for std::chrono::steady_clock
+#include <mutex>                    // for std::lock_guard
+#include <thread>                   // for std::thread, std::this_thread
+#include <algorithm>                // for std::all_of
+#include <set>                      // for std::set
+
+namespace {
+
+// How long the OSVR server may take to start up before we complain about it
+const auto CONTEXT_STARTUP_TIMEOUT = std::chrono::seconds(5);
+
+// How often to look for newly connected controllers
+const auto CONTROLLER_DISCOVERY_INTERVAL = std::chrono::seconds(1);
+
+/**
+ * Returns the indices of the controllers present in @p paths. Controllers 0
+ * and 1 are the left and right hands; the rest live at /controllerN.
+ */
+std::set<int> findControllers(const InterfacePaths& paths)
+{
+    std::set<int> indices;
+    if (hasPathUnder(paths, "/me/hands/left") || hasPathUnder(paths, "/controller/left"))
+        indices.insert(0);
+    if (hasPathUnder(paths, "/me/hands/right") || hasPathUnder(paths, "/controller/right"))
+        indices.insert(1);
+
+    const std::string prefix = "/controller";
+    for (auto it = paths.lower_bound(prefix); it != paths.end() && 0 == it->compare(0, prefix.size(), prefix); ++it) {
+        // Match /controllerN and /controllerN/...
+        const auto digits_end = it->find('/', prefix.size());
+        const auto digits = it->substr(prefix.size(), digits_end - prefix.size());
+        if (digits.empty() || digits.size() > 4 || !std::all_of(digits.begin(), digits.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }))
+            continue;
+
+        const auto index = std::stoi(digits);
+        if (index >= 2)
+            indices.insert(index);
+    }
+
+    return indices;
+}
+
+/**
+ * Raises the priority of the client update thread so pose callbacks aren't
+ * starved by the rest of vrserver. This is best-effort: it commonly fails on
+ * POSIX systems without real-time privileges.
+ */
+void raiseThreadPriority(std::thread& thread)
+{
+#if defined(OSVR_WINDOWS)
+    if (!SetThreadPriority(thread.native_handle(), THREAD_PRIORITY_HIGHEST)) {
+        OSVR_LOG(debug) << "raiseThreadPriority(): Unable to raise the priority of the client update thread.";
+    }
+#else
+    sched_param param = {};
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+    if (0 != pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param)) {
+        OSVR_LOG(debug) << "raiseThreadPriority(): Unable to raise the priority of the client update thread.";
+    }
+#endif
+}
+
+} // end anonymous namespace
 
 vr::EVRInitError ServerDriver_OSVR::Init(vr::IDriverLog* driver_log, vr::IServerDriverHost* driver_host, const char* user_driver_config_dir, const char* driver_install_dir)
 {
     if (driver_log)
         Logging::instance().setDriverLog(driver_log);
 
+    driverHost_ = driver_host;
     context_ = std::make_unique<osvr::clientkit::ClientContext>("org.osvr.SteamVR");
+    contextReady_ = false;
+    contextTimeoutReported_ = false;
+    contextDeadline_ = std::chrono::steady_clock::now() + CONTEXT_STARTUP_TIMEOUT;
 
-    trackedDevices_.emplace_back(std::make_unique<OSVRTrackedHMD>(*(context_.get()), driver_host));
+    const std::string config_dir = user_driver_config_dir ? user_driver_config_dir : "";
+    auto hmd = std::make_unique<OSVRTrackedHMD>(*(context_.get()), driver_host, config_dir);
+    hmd_ = hmd.get();
+    trackedDevices_.emplace_back(std::move(hmd));
     trackedDevices_.emplace_back(std::make_unique<OSVRTrackingReference>(*(context_.get()), driver_host));
 
+    settings_ = std::make_unique<Settings>(driver_host->GetSettings(vr::IVRSettings_Version));
+    if (settings_->getSetting<bool>("clientUpdateThread", false)) {
+        startClientUpdateThread(settings_->getSetting<int32_t>("clientUpdateRateHz", 1000));
+    }
+
     return vr::VRInitError_None;
 }
 
 void ServerDriver_OSVR::Cleanup()
 {
+    stopClientUpdateThread();
+    hmd_ = nullptr;
     trackedDevices_.clear();
+    controllerIndices_.clear();
     context_.reset();
+    driverHost_ = nullptr;
 }
 
 const char* const* ServerDriver_OSVR::GetInterfaceVersions()
@@ -101,7 +193,19 @@ vr::ITrackedDeviceServerDriver* ServerDriver_OSVR::FindTrackedDeviceDriver(const
 
 void ServerDriver_OSVR::RunFrame()
 {
-    context_->update();
+    if (!clientUpdateThread_.joinable()) {
+        updateContext();
+    }
+
+    const bool context_ready = contextReady_;
+    if (context_ready && std::chrono::steady_clock::now() >= nextControllerDiscovery_) {
+        discoverControllers();
+        nextControllerDiscovery_ = std::chrono::steady_clock::now() + CONTROLLER_DISCOVERY_INTERVAL;
+    }
+
+    for (auto& tracked_device : trackedDevices_) {
+        tracked_device->runFrame(context_ready);
+    }
 }
 
 bool ServerDriver_OSVR::ShouldBlockStandbyMode()
@@ -116,7 +220,10 @@ void ServerDriver_OSVR::EnterStandby()
 
 void ServerDriver_OSVR::LeaveStandby()
 {
-    // TODO
+    // Displays may have been connected or disconnected while we were asleep
+    if (hmd_) {
+        hmd_->displaysChanged();
+    }
 }
 
 std::string ServerDriver_OSVR::getDeviceId(vr::ITrackedDeviceServerDriver* device)
@@ -131,3 +238,101 @@ std::string ServerDriver_OSVR::getDeviceId(vr::ITrackedDeviceServerDriver* devic
     }
 }
 
+
+void ServerDriver_OSVR::updateContext()
+{
+    context_->update();
+
+    // All devices share one context, so its startup is checked here once per
+    // update rather than by each device.
+    if (!contextReady_) {
+        contextReady_ = context_->checkStatus();
+        if (contextReady_) {
+            OSVR_LOG(info) << "ServerDriver_OSVR::updateContext(): Context started up.";
+        } else if (!contextTimeoutReported_ && std::chrono::steady_clock::now() > contextDeadline_) {
+            OSVR_LOG(warn) << "ServerDriver_OSVR::updateContext(): Context startup timed out! Still waiting...";
+            contextTimeoutReported_ = true;
+        }
+    }
+}
+
+void ServerDriver_OSVR::discoverControllers()
+{
+    const auto paths = [this] {
+        std::unique_lock<std::mutex> lock(contextMutex_, std::defer_lock);
+        if (clientUpdateThread_.joinable())
+            lock.lock();
+        return getInterfacePaths(*context_);
+    }();
+
+    for (const auto index : findControllers(paths)) {
+        if (controllerIndices_.count(index))
+            continue;
+
+        std::unique_ptr<OSVRTrackedDevice> controller = std::make_unique<OSVRTrackedController>(*(context_.get()), driverHost_, index);
+        if (clientUpdateThread_.joinable()) {
+            controller->contextMutex_ = &contextMutex_;
+            controller->queuePoses_ = true;
+        }
+
+        const auto device_id = getDeviceId(controller.get());
+        trackedDevices_.emplace_back(std::move(controller));
+        controllerIndices_.insert(index);
+
+        OSVR_LOG(info) << "ServerDriver_OSVR::discoverControllers(): Found controller " << device_id << ".";
+        driverHost_->TrackedDeviceAdded(device_id.c_str());
+    }
+}
+
+void ServerDriver_OSVR::startClientUpdateThread(int32_t update_rate_hz)
+{
+    if (update_rate_hz <= 0) {
+        OSVR_LOG(warn) << "ServerDriver_OSVR::startClientUpdateThread(): Invalid update rate " << update_rate_hz << " Hz, using RunFrame() instead.";
+        return;
+    }
+
+    // Tracker callbacks will now fire on the client update thread, so the
+    // devices queue their poses for RunFrame() and lock the context before
+    // touching it.
+    for (auto& tracked_device : trackedDevices_) {
+        tracked_device->contextMutex_ = &contextMutex_;
+        tracked_device->queuePoses_ = true;
+    }
+
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / update_rate_hz));
+    stopClientUpdate_ = false;
+    clientUpdateThread_ = std::thread([this, period] {
+        auto next_update = std::chrono::steady_clock::now();
+        while (!stopClientUpdate_) {
+            {
+                std::lock_guard<std::mutex> lock(contextMutex_);
+                updateContext();
+            }
+
+            next_update += period;
+            const auto now = std::chrono::steady_clock::now();
+            if (next_update < now) {
+                // Don't try to catch up after a stall
+                next_update = now;
+            }
+            std::this_thread::sleep_until(next_update);
+        }
+    });
+    raiseThreadPriority(clientUpdateThread_);
+
+    OSVR_LOG(info) << "ServerDriver_OSVR::startClientUpdateThread(): Updating the client context at " << update_rate_hz << " Hz.";
+}
+
+void ServerDriver_OSVR::stopClientUpdateThread()
+{
+    if (!clientUpdateThread_.joinable())
+        return;
+
+    stopClientUpdate_ = true;
+    clientUpdateThread_.join();
+
+    for (auto& tracked_device : trackedDevices_) {
+        tracked_device->contextMutex_ = nullptr;
+        tracked_device->queuePoses_ = false;
+    }
+}
@@ -27,6 +27,7 @@
 
 // Internal Includes
 #include "OSVRTrackedDevice.h"          // for OSVRTrackedDevice
+#include "Settings.h"                   // for Settings
 #include "osvr_compiler_detection.h"    // for OSVR_OVERRIDE
 
 // Library/third-party includes
@@ -39,6 +40,13 @@
 #include <cstring>                      // for std::strcmp
 #include <string>                       // for std::string, std::to_string
 #include <memory>                       // for std::unique_ptr
+#include <chrono>                       // for std::chrono::steady_clock
+#include <atomic>                       // for std::atomic
+#include <mutex>                        // for std::mutex
+#include <set>                          // for std::set
+#include <thread>                       // for std::thread
+
+class OSVRTrackedHMD;
 
 class ServerDriver_OSVR : public vr::IServerTrackedDeviceProvider {
 public:
@@ -123,8 +131,54 @@ private:
      */
     std::string getDeviceId(vr::ITrackedDeviceServerDriver* device);
 
-    std::vector<std::unique_ptr<vr::ITrackedDeviceServerDriver>> trackedDevices_;
+    /**
+     * Updates the client context and checks whether it has started up.
+     */
+    void updateContext();
+
+    /**
+     * Looks for controllers in the OSVR path tree and tells SteamVR about
+     * any we haven't seen before.
+     */
+    void discoverControllers();
+
+    /**
+     * Starts updating the client context on its own thread at
+     * @p update_rate_hz.
+     */
+    void startClientUpdateThread(int32_t update_rate_hz);
+
+    /**
+     * Stops and joins the client update thread, if running.
+     */
+    void stopClientUpdateThread();
+
+    std::vector<std::unique_ptr<OSVRTrackedDevice>> trackedDevices_;
+    OSVRTrackedHMD* hmd_ = nullptr; ///< owned by trackedDevices_
     std::unique_ptr<osvr::clientkit::ClientContext> context_;
+    vr::IServerDriverHost* driverHost_ = nullptr;
+
+    std::unique_ptr<Settings> settings_;
+
+    /** \name Shared context startup barrier. */
+    //@{
+    std::atomic<bool> contextReady_ { false };
+    bool contextTimeoutReported_ = false;
+    std::chrono::steady_clock::time_point contextDeadline_;
+    //@}
+
+    /** \name Optional client update thread. */
+    //@{
+    std::thread clientUpdateThread_;
+    std::atomic<bool> stopClientUpdate_ { false };
+    std::mutex contextMutex_;
+    //@}
+
+    /** \name Controller discovery. */
+    //@{
+    std::set<int> controllerIndices_;   ///< controllers already handed to SteamVR
+    std::chrono::steady_clock::time_point nextControllerDiscovery_;
+    //@}
 };
 
 #endif // INCLUDED_ServerDriver_OSVR_h_GUID_136B1359_C29D_4198_9CA0_1C223CC83B84
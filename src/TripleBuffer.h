@@ -0,0 +1,91 @@
+/** @file
+    @brief Lock-free single-producer, single-consumer triple buffer.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_TripleBuffer_h_GUID_8A4E1C6B_2D7F_4B39_9E05_6F13D2C8A7B4
+#define INCLUDED_TripleBuffer_h_GUID_8A4E1C6B_2D7F_4B39_9E05_6F13D2C8A7B4
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Hands the newest value from one producer thread to one consumer
+ * thread without either side ever blocking.
+ *
+ * The producer and the consumer each own one of the three slots; the third
+ * slot is swapped with whichever side finishes next. Values written faster
+ * than they are read are overwritten, so the consumer always sees the newest
+ * one.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /**
+     * Publishes @p value. Must only be called from the producer thread.
+     *
+     * @return @c true if @p value replaced one the consumer never read.
+     */
+    bool write(const T& value)
+    {
+        slots_[back_] = value;
+        const auto previous = middle_.exchange(static_cast<uint8_t>(back_ | DIRTY), std::memory_order_acq_rel);
+        back_ = previous & INDEX_MASK;
+        return (previous & DIRTY) != 0;
+    }
+
+    /**
+     * Copies the newest value into @p value if one has been written since the
+     * last call. Must only be called from the consumer thread.
+     *
+     * @return @c true if @p value was updated.
+     */
+    bool read(T& value)
+    {
+        if (!(middle_.load(std::memory_order_acquire) & DIRTY))
+            return false;
+
+        const auto previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & INDEX_MASK;
+        value = slots_[front_];
+        return true;
+    }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t DIRTY = 0x4;
+
+    T slots_[3] = {};
+    uint8_t back_ = 0;                 // owned by the producer
+    std::atomic<uint8_t> middle_ { 1 }; // shared, with the DIRTY flag
+    uint8_t front_ = 2;                // owned by the consumer
+};
+
+#endif // INCLUDED_TripleBuffer_h_GUID_8A4E1C6B_2D7F_4B39_9E05_6F13D2C8A7B4
@@ -91,6 +91,44 @@ struct DisplayAdapter {
     }
 };
 
+/**
+ * A refresh rate kept as the exact ratio the hardware reports (e.g., pixel
+ * clock over pixels per frame) rather than a rounded number of hertz.
+ */
+struct RefreshRate {
+    uint32_t numerator;
+    uint32_t denominator;
+
+    /// Returns the refresh rate in Hz, or 0 if it's unknown.
+    double hertz() const
+    {
+        if (0 == numerator || 0 == denominator) return 0.0;
+
+        return static_cast<double>(numerator) / static_cast<double>(denominator);
+    }
+
+    /// Returns the time between vsyncs in seconds, or 0 if it's unknown.
+    double period() const
+    {
+        if (0 == numerator || 0 == denominator) return 0.0;
+
+        return static_cast<double>(denominator) / static_cast<double>(numerator);
+    }
+
+    bool operator==(const RefreshRate& other) const
+    {
+        // Equal ratios compare equal, e.g., 60/1 and 148500000/2475000.
+        if (0 == denominator || 0 == other.denominator) return numerator == other.numerator && denominator == other.denominator;
+
+        return static_cast<uint64_t>(numerator) * other.denominator == static_cast<uint64_t>(other.numerator) * denominator;
+    }
+
+    bool operator!=(const RefreshRate& other) const
+    {
+        return !(*this == other);
+    }
+};
+
 enum class Rotation {
     Zero,
     Ninety,
@@ -104,7 +142,7 @@ struct Display {
     DisplaySize size;
     DisplayPosition position;
     Rotation rotation;
-    double verticalRefreshRate;
+    RefreshRate verticalRefreshRate;
     bool attachedToDesktop;
     uint32_t edidVendorId;
     uint32_t edidProductId;
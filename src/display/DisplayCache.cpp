@@ -0,0 +1,172 @@
+/** @file
+    @brief Implementation of DisplayCache.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "DisplayCache.h"
+#include "DisplayEnumerator.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <future>
+#include <utility>
+
+namespace osvr {
+namespace display {
+
+DisplayCache::DisplayCache(Clock::duration time_to_live) : DisplayCache(time_to_live, &osvr::display::getDisplays, makeDisplayHotplugMonitor())
+{
+    // do nothing
+}
+
+DisplayCache::DisplayCache(Clock::duration time_to_live, Enumerator enumerator, std::unique_ptr<DisplayHotplugMonitor> monitor) : timeToLive_(time_to_live), enumerator_(std::move(enumerator)), monitor_(std::move(monitor))
+{
+    // do nothing
+}
+
+DisplayCache::Snapshot DisplayCache::getDisplays()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto now = Clock::now();
+    checkForChanges(now);
+    if (stale_)
+        refresh(now);
+
+    return snapshot_;
+}
+
+void DisplayCache::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!stale_) {
+        stale_ = true;
+        pendingRefresh_ = Refresh::Requested;
+    }
+}
+
+bool DisplayCache::poll()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto now = Clock::now();
+    checkForChanges(now);
+    const auto previous = snapshot_;
+    if (stale_) {
+        refresh(now);
+    } else if (background_.valid() && std::future_status::ready == background_.wait_for(Clock::duration::zero())) {
+        install(background_.get(), now, backgroundRefresh_);
+        if (backgroundOutdated_)
+            startBackgroundRefresh(Refresh::Hotplug);
+    } else {
+        return false;
+    }
+
+    return !previous || *previous != *snapshot_;
+}
+
+bool DisplayCache::hasHotplugMonitor() const
+{
+    return static_cast<bool>(monitor_);
+}
+
+uint64_t DisplayCache::getRefreshCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return refreshCount_;
+}
+
+DisplayCache::Refresh DisplayCache::getLastRefresh() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastRefresh_;
+}
+
+void DisplayCache::checkForChanges(Clock::time_point now)
+{
+    // Always drain the monitor so old notifications don't pile up
+    const auto hotplug = monitor_ && monitor_->poll();
+    if (stale_)
+        return;
+
+    // Enumerating can take tens of milliseconds, so don't make the caller
+    // (usually the frame thread) wait for it.
+    if (hotplug) {
+        startBackgroundRefresh(Refresh::Hotplug);
+    } else if (Clock::duration::zero() != timeToLive_ && now >= expiry_ && !background_.valid()) {
+        startBackgroundRefresh(Refresh::Expired);
+    }
+}
+
+void DisplayCache::refresh(Clock::time_point now)
+{
+    // A background enumeration may have started before the change; waiting
+    // for it here is rare and cheaper than racing it.
+    background_ = std::future<std::vector<Display>>();
+    backgroundOutdated_ = false;
+    install(enumerator_(), now, pendingRefresh_);
+}
+
+void DisplayCache::startBackgroundRefresh(Refresh reason)
+{
+    if (background_.valid()) {
+        backgroundOutdated_ = true;
+        return;
+    }
+
+    background_ = std::async(std::launch::async, enumerator_);
+    backgroundRefresh_ = reason;
+    backgroundOutdated_ = false;
+}
+
+void DisplayCache::install(std::vector<Display> displays, Clock::time_point now, Refresh reason)
+{
+    snapshot_ = std::make_shared<std::vector<Display>>(std::move(displays));
+    expiry_ = now + timeToLive_;
+    stale_ = false;
+    lastRefresh_ = reason;
+    ++refreshCount_;
+}
+
+const char* to_string(DisplayCache::Refresh refresh)
+{
+    switch (refresh) {
+    case DisplayCache::Refresh::Initial:
+        return "initial";
+    case DisplayCache::Refresh::Requested:
+        return "requested";
+    case DisplayCache::Refresh::Hotplug:
+        return "hotplug";
+    case DisplayCache::Refresh::Expired:
+        return "expired";
+    }
+
+    return "unknown";
+}
+
+} // namespace display
+} // namespace osvr
@@ -0,0 +1,167 @@
+/** @file
+    @brief Cached display enumeration.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_DisplayCache_h_GUID_D1433F1E_5BD7_4B50_91DF_5821F900195E
+#define INCLUDED_DisplayCache_h_GUID_D1433F1E_5BD7_4B50_91DF_5821F900195E
+
+// Internal Includes
+#include "Display.h"
+#include "DisplayHotplugMonitor.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace osvr {
+namespace display {
+
+/**
+ * Remembers the result of getDisplays() and only enumerates the displays
+ * again when a hotplug notification arrives, the time-to-live runs out, or
+ * invalidate() is called.
+ *
+ * Snapshots outdated by a hotplug notification or expiry are refreshed on a
+ * background thread and keep being returned until the new one is ready, so
+ * neither makes poll() or getDisplays() wait for an enumeration.
+ *
+ * Safe to use from several threads.
+ */
+class DisplayCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Snapshot = std::shared_ptr<const std::vector<Display>>;
+    using Enumerator = std::function<std::vector<Display>()>;
+
+    /**
+     * Why the displays were last enumerated.
+     */
+    enum class Refresh {
+        Initial,    ///< first use
+        Requested,  ///< invalidate() was called
+        Hotplug,    ///< the hotplug monitor reported a change
+        Expired     ///< the time-to-live ran out
+    };
+
+    /**
+     * @param time_to_live how long a snapshot may be used before the
+     *     displays are enumerated again, or zero to rely on hotplug
+     *     notifications and invalidate() alone. Only needed where
+     *     hasHotplugMonitor() is false.
+     */
+    explicit DisplayCache(Clock::duration time_to_live = Clock::duration::zero());
+
+    /**
+     * Uses @p enumerator instead of getDisplays() and @p monitor, which may
+     * be null, instead of the platform's hotplug monitor.
+     */
+    DisplayCache(Clock::duration time_to_live, Enumerator enumerator, std::unique_ptr<DisplayHotplugMonitor> monitor);
+
+    /**
+     * Returns the current displays, enumerating them first if the snapshot is
+     * out of date. The snapshot never changes once returned.
+     */
+    Snapshot getDisplays();
+
+    /**
+     * Enumerates the displays again the next time they're needed.
+     */
+    void invalidate();
+
+    /**
+     * Checks for hotplug notifications and expiry. invalidate() enumerates
+     * the displays right away; a notification or expiry starts a background
+     * enumeration that a later poll() picks up.
+     *
+     * @return true if the displays differ from the previous snapshot.
+     */
+    bool poll();
+
+    /**
+     * Returns true if this platform reports displays being connected or
+     * disconnected.
+     */
+    bool hasHotplugMonitor() const;
+
+    /** \name Statistics */
+    //@{
+    uint64_t getRefreshCount() const;
+    Refresh getLastRefresh() const;
+    //@}
+
+private:
+    /**
+     * Notes why the snapshot is out of date, if it is. Called with mutex_
+     * held.
+     */
+    void checkForChanges(Clock::time_point now);
+
+    /**
+     * Enumerates the displays, abandoning any background enumeration. Called
+     * with mutex_ held.
+     */
+    void refresh(Clock::time_point now);
+
+    /**
+     * Enumerates the displays on a background thread. If one is already
+     * running, another starts once poll() has picked it up, since it may
+     * have missed the change. Called with mutex_ held.
+     */
+    void startBackgroundRefresh(Refresh reason);
+
+    /**
+     * Replaces the snapshot. Called with mutex_ held.
+     */
+    void install(std::vector<Display> displays, Clock::time_point now, Refresh reason);
+
+    mutable std::mutex mutex_;
+    Clock::duration timeToLive_;
+    Enumerator enumerator_;
+    std::unique_ptr<DisplayHotplugMonitor> monitor_;
+
+    Snapshot snapshot_;
+    std::future<std::vector<Display>> background_;
+    Refresh backgroundRefresh_ = Refresh::Expired;
+    bool backgroundOutdated_ = false;
+    Clock::time_point expiry_;
+    bool stale_ = true;
+    Refresh pendingRefresh_ = Refresh::Initial;
+    Refresh lastRefresh_ = Refresh::Initial;
+    uint64_t refreshCount_ = 0;
+};
+
+const char* to_string(DisplayCache::Refresh refresh);
+
+} // end namespace display
+} // end namespace osvr
+
+#endif // INCLUDED_DisplayCache_h_GUID_D1433F1E_5BD7_4B50_91DF_5821F900195E
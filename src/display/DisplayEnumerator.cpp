@@ -31,6 +31,7 @@
 #include <osvr/Util/PlatformConfig.h>
 
 // Standard includes
+#include <algorithm>
 #include <vector>
 
 #if defined(OSVR_WINDOWS)
@@ -53,3 +54,20 @@ std::vector<Display> getDisplays()
 } // namespace osvr
 #endif
 
+namespace osvr {
+namespace display {
+
+bool isAttachedToDesktop(const std::vector<Display>& displays, const Display& display)
+{
+    const auto it = std::find_if(begin(displays), end(displays), [&display](const Display& d) {
+        return d.edidVendorId == display.edidVendorId
+            && d.edidProductId == display.edidProductId
+            && d.name == display.name
+            && d.adapter == display.adapter;
+    });
+
+    return end(displays) != it && it->attachedToDesktop;
+}
+
+} // namespace display
+} // namespace osvr
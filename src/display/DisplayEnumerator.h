@@ -30,9 +30,10 @@
 #include "Display.h"
 
 // Library/third-party includes
-// - none
+#include <osvr/Util/PlatformConfig.h>
 
 // Standard includes
+#include <string>
 #include <vector>
 
 namespace osvr {
@@ -40,6 +41,28 @@ namespace display {
 
 std::vector<Display> getDisplays();
 
+#if defined(OSVR_LINUX)
+/**
+ * Enumerates the connected displays described by a Linux DRM sysfs tree.
+ * getDisplays() calls this with "/sys/class/drm"; tests point it at a fixture
+ * tree instead.
+ *
+ * @param drm_class_path the directory holding the cardN-<connector> entries.
+ */
+std::vector<Display> getDisplaysFromSysfs(const std::string& drm_class_path);
+#endif
+
+/**
+ * Returns whether @p display is attached to the desktop according to a fresh
+ * enumeration. The display is matched by identity (EDID IDs, name and
+ * adapter) rather than operator==, since its mode and desktop state may have
+ * changed since it was enumerated.
+ *
+ * @param displays the current displays, e.g., from getDisplays().
+ * @param display a display from an earlier enumeration.
+ */
+bool isAttachedToDesktop(const std::vector<Display>& displays, const Display& display);
+
 } // end namespace display
 } // end namespace osvr
 
@@ -29,23 +29,190 @@
 // Internal Includes
 #include "DisplayEnumerator.h"
 #include "Display.h"
+#include "EDID.h"
 
 // Library/third-party includes
 // - none
 
 // Standard includes
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
+#include <dirent.h>
+
 namespace osvr {
 namespace display {
 
+namespace {
+
+    // Forward declarations
+    std::vector<std::string> getConnectorNames(const std::string& drm_class_path);
+    bool isConnectorName(const std::string& name);
+    Display getDisplay(const std::string& drm_class_path, const std::string& connector_name);
+    DisplayAdapter getDisplayAdapter(const std::string& drm_class_path, const std::string& connector_name);
+    DisplaySize getFirstMode(const std::string& connector_path);
+    std::string readLine(const std::string& path);
+    bool readEDID(const std::string& path, EDID& edid);
+
+    std::vector<std::string> getConnectorNames(const std::string& drm_class_path)
+    {
+        std::vector<std::string> names;
+
+        DIR* dir = opendir(drm_class_path.c_str());
+        if (!dir)
+            return names;
+
+        while (const auto entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (isConnectorName(name))
+                names.push_back(name);
+        }
+        closedir(dir);
+
+        // readdir() order is unspecified; keep the enumeration stable so
+        // comparing two snapshots only reports real changes.
+        std::sort(begin(names), end(names));
+        return names;
+    }
+
+    bool isConnectorName(const std::string& name)
+    {
+        // Connectors are named card<N>-<connector>, e.g., card0-HDMI-A-1.
+        // Skip the cards themselves, render nodes, and the version file.
+        if (0 != name.compare(0, 4, "card"))
+            return false;
+
+        const auto dash = name.find('-');
+        if (std::string::npos == dash || 4 == dash || dash + 1 == name.size())
+            return false;
+
+        return std::all_of(name.begin() + 4, name.begin() + dash, [](char c) { return c >= '0' && c <= '9'; });
+    }
+
+    Display getDisplay(const std::string& drm_class_path, const std::string& connector_name)
+    {
+        const auto connector_path = drm_class_path + "/" + connector_name;
+        EDID edid;
+        const auto has_edid = readEDID(connector_path + "/edid", edid);
+        const auto timing = has_edid ? edid.getPreferredTiming() : nullptr;
+
+        Display display;
+        display.adapter = getDisplayAdapter(drm_class_path, connector_name);
+        display.name = has_edid ? edid.monitorName : "";
+        if (display.name.empty())
+            display.name = connector_name.substr(connector_name.find('-') + 1);
+        display.size = timing ? DisplaySize{timing->horizontalActive, timing->verticalActive} : getFirstMode(connector_path);
+        // sysfs doesn't know where the desktop places this output.
+        display.position = {0, 0};
+        display.rotation = Rotation::Zero;
+        // sysfs doesn't expose the current mode's timings; without an EDID
+        // assume the usual 60 Hz.
+        display.verticalRefreshRate = timing ? timing->refreshRate() : RefreshRate{60, 1};
+        // A connector is enabled when it's driving a CRTC. A connected but
+        // disabled HMD is available for direct mode.
+        display.attachedToDesktop = ("enabled" == readLine(connector_path + "/enabled"));
+        display.edidVendorId = has_edid ? edid.vendorId : 0x00;
+        display.edidProductId = has_edid ? edid.productId : 0x00;
+
+        return display;
+    }
+
+    DisplayAdapter getDisplayAdapter(const std::string& drm_class_path, const std::string& connector_name)
+    {
+        const auto card_name = connector_name.substr(0, connector_name.find('-'));
+
+        std::string driver;
+        std::string pci_id;
+        std::ifstream uevent(drm_class_path + "/" + card_name + "/device/uevent");
+        std::string line;
+        while (std::getline(uevent, line)) {
+            if (0 == line.compare(0, 7, "DRIVER="))
+                driver = line.substr(7);
+            else if (0 == line.compare(0, 7, "PCI_ID="))
+                pci_id = line.substr(7);
+        }
+
+        DisplayAdapter adapter;
+        adapter.description = card_name;
+        if (!driver.empty())
+            adapter.description += " " + driver;
+        if (!pci_id.empty())
+            adapter.description += " [" + pci_id + "]";
+
+        return adapter;
+    }
+
+    DisplaySize getFirstMode(const std::string& connector_path)
+    {
+        // The kernel's mode list starts with the preferred mode (e.g.,
+        // "1920x1080").
+        const auto mode = readLine(connector_path + "/modes");
+        const auto x = mode.find('x');
+        if (std::string::npos == x)
+            return {0, 0};
+
+        const auto width = std::strtoul(mode.c_str(), nullptr, 10);
+        const auto height = std::strtoul(mode.c_str() + x + 1, nullptr, 10);
+        return {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+    }
+
+    std::string readLine(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    bool readEDID(const std::string& path, EDID& edid)
+    {
+        std::ifstream file(path, std::ios::binary);
+        const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        // Connectors without a monitor (or without DDC) have an empty file.
+        const auto status = parseEDID(data.data(), data.size(), edid);
+        if (EDIDStatus::Success != status && !data.empty()) {
+            std::cerr << "readEDID(): Ignoring " << path << ": " << to_string(status) << "." << std::endl;
+        }
+
+        return EDIDStatus::Success == status;
+    }
+
+} // end anonymous namespace
+
+std::vector<Display> getDisplaysFromSysfs(const std::string& drm_class_path)
+{
+    std::vector<Display> displays;
+
+    for (const auto& connector_name : getConnectorNames(drm_class_path)) {
+        if ("connected" != readLine(drm_class_path + "/" + connector_name + "/status"))
+            continue;
+
+        try {
+            auto display = getDisplay(drm_class_path, connector_name);
+            displays.emplace_back(std::move(display));
+        } catch (const std::exception& e) {
+            std::cout << "Caught exception: " << e.what() << ".";
+            std::cout << "Ignoring this display." << std::endl;
+        }
+    }
+
+    return displays;
+}
+
 std::vector<Display> getDisplays()
 {
-    return {};
+    return getDisplaysFromSysfs("/sys/class/drm");
 }
 
 } // end namespace display
 } // end namespace osvr
 
 #endif // INCLUDED_DisplayEnumerator_Linux_h_GUID_CA8EA9D4_36A1_4492_8383_30419BD91FD3
-
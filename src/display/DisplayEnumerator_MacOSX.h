@@ -35,6 +35,7 @@
 #include <IOKit/graphics/IOGraphicsLib.h>
 
 // Standard includes
+#include <cmath>
 #include <vector>
 #include <iostream>
 
@@ -56,7 +57,7 @@ std::string getDisplayName(const CGDirectDisplayID& display_id);
 DisplaySize getDisplaySize(const CGDirectDisplayID& display_id);
 DisplayPosition getDisplayPosition(const CGDirectDisplayID& display_id);
 Rotation getDisplayRotation(const CGDirectDisplayID& display_id);
-double getDisplayRefreshRate(const CGDirectDisplayID& display_id);
+RefreshRate getDisplayRefreshRate(const CGDirectDisplayID& display_id);
 bool getDisplayAttachedToDesktop(const CGDirectDisplayID& display_id);
 uint32_t getDisplayEDIDVendorID(const CGDirectDisplayID& display_id);
 uint32_t getDisplayEDIDProductID(const CGDirectDisplayID& display_id);
@@ -244,7 +245,7 @@ Rotation getDisplayRotation(const CGDirectDisplayID& display_id)
     }
 }
 
-double getDisplayRefreshRate(const CGDirectDisplayID& display_id)
+RefreshRate getDisplayRefreshRate(const CGDirectDisplayID& display_id)
 {
     auto display_mode_ref = CGDisplayCopyDisplayMode(display_id);
     if (!display_mode_ref) {
@@ -253,7 +254,8 @@ double getDisplayRefreshRate(const CGDirectDisplayID& display_id)
     const auto refresh_rate = CGDisplayModeGetRefreshRate(display_mode_ref);
     CGDisplayModeRelease(display_mode_ref);
 
-    return refresh_rate;
+    // CoreGraphics only reports hertz; keep it to the millihertz.
+    return {static_cast<uint32_t>(std::lround(refresh_rate * 1000.0)), 1000};
 }
 
 bool getDisplayAttachedToDesktop(const CGDirectDisplayID& display_id)
@@ -60,7 +60,7 @@ namespace {
     DisplaySize getCurrentResolution(const DISPLAYCONFIG_PATH_INFO& path_info, const std::vector<DISPLAYCONFIG_MODE_INFO>& mode_info);
     DisplayPosition getPosition(const DISPLAYCONFIG_PATH_INFO& path_info, const std::vector<DISPLAYCONFIG_MODE_INFO>& mode_info);
     Rotation getRotation(const DISPLAYCONFIG_PATH_INFO& path_info);
-    double getRefreshRate(const DISPLAYCONFIG_PATH_INFO& path_info);
+    RefreshRate getRefreshRate(const DISPLAYCONFIG_PATH_INFO& path_info);
     std::pair<uint32_t, uint32_t> getEDIDInfo(const DISPLAYCONFIG_PATH_INFO& path_info);
     void checkResult(const std::string& function_name, LONG result);
 
@@ -190,13 +190,10 @@ namespace {
         }
     }
 
-    double getRefreshRate(const DISPLAYCONFIG_PATH_INFO& path_info)
+    RefreshRate getRefreshRate(const DISPLAYCONFIG_PATH_INFO& path_info)
     {
         const auto rational = path_info.targetInfo.refreshRate;
-        const auto numerator = static_cast<double>(rational.Numerator);
-        const auto denominator = static_cast<double>(rational.Denominator);
-        const auto refresh_rate = numerator / denominator;
-        return refresh_rate;
+        return {rational.Numerator, rational.Denominator};
     }
 
     Rotation getRotation(const DISPLAYCONFIG_PATH_INFO& path_info)
@@ -0,0 +1,76 @@
+/** @file
+    @brief Implementations of makeDisplayHotplugMonitor().
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "DisplayHotplugMonitor.h"
+
+// Library/third-party includes
+#include <osvr/Util/PlatformConfig.h>
+
+// Standard includes
+#include <cstring>
+#include <memory>
+
+namespace osvr {
+namespace display {
+
+bool isDisplayUevent(const char* message, std::size_t length)
+{
+    static const char SUBSYSTEM_DRM[] = "SUBSYSTEM=drm";
+
+    // The first field is "action@devpath"; the rest are KEY=value pairs.
+    const char* field = message;
+    const char* end = message + length;
+    while (field < end) {
+        const auto nul = static_cast<const char*>(std::memchr(field, '\0', static_cast<std::size_t>(end - field)));
+        const auto field_length = static_cast<std::size_t>((nul ? nul : end) - field);
+        if (field_length == sizeof(SUBSYSTEM_DRM) - 1 && 0 == std::memcmp(field, SUBSYSTEM_DRM, field_length))
+            return true;
+
+        field += field_length + 1;
+    }
+
+    return false;
+}
+
+} // namespace display
+} // namespace osvr
+
+#if defined(OSVR_LINUX)
+#include "DisplayHotplugMonitor_Linux.h"
+#else
+namespace osvr {
+namespace display {
+
+std::unique_ptr<DisplayHotplugMonitor> makeDisplayHotplugMonitor()
+{
+    // No notifications on this platform yet; DisplayCache falls back on its
+    // time-to-live.
+    return nullptr;
+}
+
+} // namespace display
+} // namespace osvr
+#endif
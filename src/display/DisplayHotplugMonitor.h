@@ -0,0 +1,70 @@
+/** @file
+    @brief Notifications of displays being connected or disconnected.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_DisplayHotplugMonitor_h_GUID_1FAB265E_36CA_4B48_B002_2D7E0EC4941B
+#define INCLUDED_DisplayHotplugMonitor_h_GUID_1FAB265E_36CA_4B48_B002_2D7E0EC4941B
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+#include <memory>
+
+namespace osvr {
+namespace display {
+
+class DisplayHotplugMonitor {
+public:
+    virtual ~DisplayHotplugMonitor() = default;
+
+    /**
+     * Returns true if displays have been connected or disconnected since the
+     * last call. Never blocks.
+     */
+    virtual bool poll() = 0;
+};
+
+/**
+ * Creates the hotplug monitor for this platform.
+ *
+ * @return the monitor, or nullptr if the platform can't report display
+ * changes.
+ */
+std::unique_ptr<DisplayHotplugMonitor> makeDisplayHotplugMonitor();
+
+/**
+ * Returns true if @p message, a kernel uevent of @p length bytes made of
+ * NUL-separated fields, is about a DRM device (a GPU connector changing).
+ */
+bool isDisplayUevent(const char* message, std::size_t length);
+
+} // end namespace display
+} // end namespace osvr
+
+#endif // INCLUDED_DisplayHotplugMonitor_h_GUID_1FAB265E_36CA_4B48_B002_2D7E0EC4941B
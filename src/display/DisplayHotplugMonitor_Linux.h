@@ -0,0 +1,118 @@
+/** @file
+    @brief Display hotplug notifications from the kernel's DRM uevents.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_DisplayHotplugMonitor_Linux_h_GUID_C4D5F6E7_9C89_43EA_94F4_C758CC77B893
+#define INCLUDED_DisplayHotplugMonitor_Linux_h_GUID_C4D5F6E7_9C89_43EA_94F4_C758CC77B893
+
+// Internal Includes
+#include "DisplayHotplugMonitor.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cerrno>
+#include <memory>
+
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace osvr {
+namespace display {
+
+/**
+ * Listens to the kernel uevent netlink socket (the same source udev
+ * monitors) for events from the DRM subsystem, which the kernel sends when a
+ * connector's status changes.
+ */
+class DisplayHotplugMonitorLinux : public DisplayHotplugMonitor {
+public:
+    explicit DisplayHotplugMonitorLinux(int socket) : socket_(socket)
+    {
+        // do nothing
+    }
+
+    virtual ~DisplayHotplugMonitorLinux()
+    {
+        ::close(socket_);
+    }
+
+    virtual bool poll() override
+    {
+        // Drain every queued event so a burst of them is reported once
+        bool changed = false;
+        char buffer[8192];
+        for (;;) {
+            sockaddr_nl sender = {};
+            socklen_t sender_length = sizeof(sender);
+            const auto length = ::recvfrom(socket_, buffer, sizeof(buffer), MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&sender), &sender_length);
+            if (length < 0 && ENOBUFS == errno) {
+                // The socket overran and dropped events, any of which could
+                // have been a hotplug
+                changed = true;
+                continue;
+            }
+            if (length < 0 && EINTR == errno)
+                continue;
+            if (length <= 0)
+                break;
+
+            // Only trust messages from the kernel, not other processes
+            if (0 != sender.nl_pid)
+                continue;
+
+            if (isDisplayUevent(buffer, static_cast<std::size_t>(length)))
+                changed = true;
+        }
+
+        return changed;
+    }
+
+private:
+    int socket_;
+};
+
+std::unique_ptr<DisplayHotplugMonitor> makeDisplayHotplugMonitor()
+{
+    const int fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0)
+        return nullptr;
+
+    sockaddr_nl address = {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1; // kernel uevents
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    return std::unique_ptr<DisplayHotplugMonitor>(new DisplayHotplugMonitorLinux(fd));
+}
+
+} // end namespace display
+} // end namespace osvr
+
+#endif // INCLUDED_DisplayHotplugMonitor_Linux_h_GUID_C4D5F6E7_9C89_43EA_94F4_C758CC77B893
@@ -0,0 +1,273 @@
+/** @file
+    @brief Implementation of the EDID parser.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "EDID.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace osvr {
+namespace display {
+
+const std::size_t EDID::BLOCK_SIZE;
+const std::size_t EDID::MAX_DETAILED_TIMINGS;
+const std::size_t EDID::MAX_VIDEO_CODES;
+const std::size_t EDID::MAX_STRING_LENGTH;
+
+namespace {
+
+    // Base block layout (VESA E-EDID 1.3/1.4)
+    const std::size_t DESCRIPTOR_OFFSET = 54;
+    const std::size_t DESCRIPTOR_SIZE = 18;
+    const std::size_t DESCRIPTOR_COUNT = 4;
+    const std::size_t EXTENSION_COUNT_OFFSET = 126;
+    const uint8_t MONITOR_NAME_TAG = 0xfc;
+    const uint8_t SERIAL_STRING_TAG = 0xff;
+
+    // CTA-861 extension block layout
+    const uint8_t CTA_EXTENSION_TAG = 0x02;
+    const std::size_t CTA_DATA_BLOCK_OFFSET = 4;
+    const uint8_t CTA_VIDEO_DATA_BLOCK = 2;
+
+    bool hasValidChecksum(const uint8_t* block)
+    {
+        uint8_t sum = 0;
+        for (std::size_t i = 0; i < EDID::BLOCK_SIZE; ++i)
+            sum = static_cast<uint8_t>(sum + block[i]);
+
+        return 0 == sum;
+    }
+
+    bool isDetailedTiming(const uint8_t* descriptor)
+    {
+        // Display descriptors start with a zero pixel clock.
+        return 0 != descriptor[0] || 0 != descriptor[1];
+    }
+
+    DetailedTiming parseDetailedTiming(const uint8_t* d)
+    {
+        DetailedTiming timing;
+        timing.pixelClock = static_cast<uint32_t>(d[0] | (d[1] << 8)) * 10000u;
+        timing.horizontalActive = static_cast<uint16_t>(d[2] | ((d[4] & 0xf0) << 4));
+        timing.horizontalBlanking = static_cast<uint16_t>(d[3] | ((d[4] & 0x0f) << 8));
+        timing.verticalActive = static_cast<uint16_t>(d[5] | ((d[7] & 0xf0) << 4));
+        timing.verticalBlanking = static_cast<uint16_t>(d[6] | ((d[7] & 0x0f) << 8));
+        timing.horizontalSyncOffset = static_cast<uint16_t>(d[8] | ((d[11] & 0xc0) << 2));
+        timing.horizontalSyncWidth = static_cast<uint16_t>(d[9] | ((d[11] & 0x30) << 4));
+        timing.verticalSyncOffset = static_cast<uint16_t>((d[10] >> 4) | ((d[11] & 0x0c) << 2));
+        timing.verticalSyncWidth = static_cast<uint16_t>((d[10] & 0x0f) | ((d[11] & 0x03) << 4));
+        timing.widthMillimeters = static_cast<uint16_t>(d[12] | ((d[14] & 0xf0) << 4));
+        timing.heightMillimeters = static_cast<uint16_t>(d[13] | ((d[14] & 0x0f) << 8));
+        timing.interlaced = (0 != (d[17] & 0x80));
+        return timing;
+    }
+
+    void addDetailedTiming(const uint8_t* descriptor, EDID& edid)
+    {
+        if (edid.detailedTimingCount == EDID::MAX_DETAILED_TIMINGS)
+            return;
+
+        edid.detailedTimings[edid.detailedTimingCount++] = parseDetailedTiming(descriptor);
+    }
+
+    void copyDescriptorString(const uint8_t* descriptor, char* out)
+    {
+        // Up to 13 characters, terminated by a line feed and padded with
+        // spaces.
+        std::size_t length = 0;
+        while (length < EDID::MAX_STRING_LENGTH) {
+            const auto c = static_cast<char>(descriptor[5 + length]);
+            if ('\n' == c || '\0' == c)
+                break;
+            out[length++] = c;
+        }
+        while (length > 0 && ' ' == out[length - 1])
+            --length;
+        out[length] = '\0';
+    }
+
+    void parseBaseBlock(const uint8_t* block, EDID& edid)
+    {
+        // The manufacturer ID is three 5-bit letters, big-endian.
+        const auto manufacturer = static_cast<uint16_t>((block[8] << 8) | block[9]);
+        edid.manufacturer[0] = static_cast<char>('@' + ((manufacturer >> 10) & 0x1f));
+        edid.manufacturer[1] = static_cast<char>('@' + ((manufacturer >> 5) & 0x1f));
+        edid.manufacturer[2] = static_cast<char>('@' + (manufacturer & 0x1f));
+        edid.manufacturer[3] = '\0';
+        edid.vendorId = static_cast<uint32_t>(block[8] | (block[9] << 8));
+        edid.productId = static_cast<uint32_t>(block[10] | (block[11] << 8));
+        edid.serialNumber = static_cast<uint32_t>(block[12]) | (static_cast<uint32_t>(block[13]) << 8) | (static_cast<uint32_t>(block[14]) << 16) | (static_cast<uint32_t>(block[15]) << 24);
+        edid.manufactureWeek = block[16];
+        edid.manufactureYear = static_cast<uint16_t>(1990 + block[17]);
+        edid.version = block[18];
+        edid.revision = block[19];
+        edid.extensionCount = block[EXTENSION_COUNT_OFFSET];
+
+        for (std::size_t i = 0; i < DESCRIPTOR_COUNT; ++i) {
+            const auto descriptor = block + DESCRIPTOR_OFFSET + i * DESCRIPTOR_SIZE;
+            if (isDetailedTiming(descriptor)) {
+                if (0 == i)
+                    edid.hasPreferredTiming = true;
+                addDetailedTiming(descriptor, edid);
+            } else if (MONITOR_NAME_TAG == descriptor[3]) {
+                copyDescriptorString(descriptor, edid.monitorName);
+            } else if (SERIAL_STRING_TAG == descriptor[3]) {
+                copyDescriptorString(descriptor, edid.serialString);
+            }
+        }
+    }
+
+    void parseVideoDataBlock(const uint8_t* payload, std::size_t length, EDID& edid)
+    {
+        for (std::size_t i = 0; i < length; ++i) {
+            // VICs 1-64 borrow bit 7 as the native flag; 193 and up are
+            // plain VICs.
+            const auto svd = payload[i];
+            const bool native = (svd >= 129 && svd <= 192);
+            const auto vic = static_cast<uint8_t>(native ? (svd & 0x7f) : svd);
+            if (0 == vic || 128 == vic || vic >= 254)
+                continue;
+
+            if (native && 0 == edid.nativeVideoCode)
+                edid.nativeVideoCode = vic;
+            if (edid.videoCodeCount < EDID::MAX_VIDEO_CODES)
+                edid.videoCodes[edid.videoCodeCount++] = vic;
+        }
+    }
+
+    void parseCTAExtension(const uint8_t* block, EDID& edid)
+    {
+        const auto revision = block[1];
+        const std::size_t dtd_offset = block[2];
+
+        // An offset of zero means there are neither data blocks nor
+        // detailed timings; anything else must leave room for the header.
+        if (0 == dtd_offset)
+            return;
+        if (dtd_offset < CTA_DATA_BLOCK_OFFSET || dtd_offset >= EDID::BLOCK_SIZE - 1)
+            return;
+
+        // Revision 1 has no data block collection.
+        if (revision >= 3) {
+            std::size_t offset = CTA_DATA_BLOCK_OFFSET;
+            while (offset < dtd_offset) {
+                const auto tag = static_cast<uint8_t>(block[offset] >> 5);
+                const std::size_t length = block[offset] & 0x1f;
+                if (offset + 1 + length > dtd_offset)
+                    break;
+
+                if (CTA_VIDEO_DATA_BLOCK == tag)
+                    parseVideoDataBlock(block + offset + 1, length, edid);
+
+                offset += 1 + length;
+            }
+        }
+
+        // Detailed timings run until a zero pixel clock or the checksum byte.
+        for (std::size_t offset = dtd_offset; offset + DESCRIPTOR_SIZE < EDID::BLOCK_SIZE; offset += DESCRIPTOR_SIZE) {
+            const auto descriptor = block + offset;
+            if (!isDetailedTiming(descriptor))
+                break;
+            addDetailedTiming(descriptor, edid);
+        }
+
+        ++edid.ctaExtensionCount;
+    }
+
+} // end anonymous namespace
+
+uint32_t DetailedTiming::horizontalTotal() const
+{
+    return static_cast<uint32_t>(horizontalActive) + horizontalBlanking;
+}
+
+uint32_t DetailedTiming::verticalTotal() const
+{
+    return static_cast<uint32_t>(verticalActive) + verticalBlanking;
+}
+
+RefreshRate DetailedTiming::refreshRate() const
+{
+    // Each total fits in 13 bits, so the product fits in 32.
+    return {pixelClock, horizontalTotal() * verticalTotal()};
+}
+
+const char* to_string(EDIDStatus status)
+{
+    switch (status) {
+    case EDIDStatus::Success:
+        return "Success";
+    case EDIDStatus::TooShort:
+        return "EDID is shorter than one block";
+    case EDIDStatus::BadHeader:
+        return "EDID header is missing";
+    case EDIDStatus::BadChecksum:
+        return "EDID base block checksum is wrong";
+    }
+
+    return "Unknown EDID status";
+}
+
+const DetailedTiming* EDID::getPreferredTiming() const
+{
+    return hasPreferredTiming ? &detailedTimings[0] : nullptr;
+}
+
+EDIDStatus parseEDID(const uint8_t* data, std::size_t size, EDID& edid)
+{
+    static const uint8_t header[] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+
+    std::memset(&edid, 0, sizeof(edid));
+
+    if (!data || size < EDID::BLOCK_SIZE)
+        return EDIDStatus::TooShort;
+    if (0 != std::memcmp(data, header, sizeof(header)))
+        return EDIDStatus::BadHeader;
+    if (!hasValidChecksum(data))
+        return EDIDStatus::BadChecksum;
+
+    parseBaseBlock(data, edid);
+
+    const auto available_extensions = size / EDID::BLOCK_SIZE - 1;
+    const auto extensions = (edid.extensionCount < available_extensions) ? edid.extensionCount : available_extensions;
+    for (std::size_t i = 1; i <= extensions; ++i) {
+        const auto block = data + i * EDID::BLOCK_SIZE;
+        if (CTA_EXTENSION_TAG != block[0] || !hasValidChecksum(block))
+            continue;
+
+        parseCTAExtension(block, edid);
+    }
+
+    return EDIDStatus::Success;
+}
+
+} // end namespace display
+} // end namespace osvr
@@ -0,0 +1,145 @@
+/** @file
+    @brief Parser for Extended Display Identification Data (EDID) blobs.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_EDID_h_GUID_7F8A4FF9_99FD_4313_AECE_0FCC3C40DB98
+#define INCLUDED_EDID_h_GUID_7F8A4FF9_99FD_4313_AECE_0FCC3C40DB98
+
+// Internal Includes
+#include "Display.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+
+namespace osvr {
+namespace display {
+
+/**
+ * A detailed timing descriptor from the base block or a CTA-861 extension.
+ */
+struct DetailedTiming {
+    uint32_t pixelClock; ///< in Hz
+    uint16_t horizontalActive;
+    uint16_t horizontalBlanking;
+    uint16_t horizontalSyncOffset;
+    uint16_t horizontalSyncWidth;
+    uint16_t verticalActive;
+    uint16_t verticalBlanking;
+    uint16_t verticalSyncOffset;
+    uint16_t verticalSyncWidth;
+    uint16_t widthMillimeters;
+    uint16_t heightMillimeters;
+    bool interlaced;
+
+    uint32_t horizontalTotal() const;
+    uint32_t verticalTotal() const;
+
+    /**
+     * Returns the exact vertical refresh rate: the pixel clock over the
+     * pixels per frame, blanking included (the field rate for interlaced
+     * timings).
+     */
+    RefreshRate refreshRate() const;
+};
+
+enum class EDIDStatus {
+    Success,
+    TooShort,    ///< Shorter than one 128-byte block
+    BadHeader,   ///< Missing the 00 FF FF FF FF FF FF 00 header
+    BadChecksum  ///< The base block doesn't sum to zero
+};
+
+const char* to_string(EDIDStatus status);
+
+/**
+ * The decoded contents of an EDID base block and its CTA-861 extensions.
+ *
+ * Holds everything in fixed-size arrays so parsing never allocates; it's
+ * safe to call on every hotplug and on untrusted input.
+ */
+struct EDID {
+    static const std::size_t BLOCK_SIZE = 128;
+    static const std::size_t MAX_DETAILED_TIMINGS = 16;
+    static const std::size_t MAX_VIDEO_CODES = 32;
+    static const std::size_t MAX_STRING_LENGTH = 13;
+
+    /// Manufacturer ID in the byte order Windows reports, e.g., 0xd24e for
+    /// "SVR".
+    uint32_t vendorId;
+    /// Three-letter PNP manufacturer ID, e.g., "SVR".
+    char manufacturer[4];
+    uint32_t productId;
+    uint32_t serialNumber;
+    uint8_t manufactureWeek;
+    uint16_t manufactureYear;
+    uint8_t version;
+    uint8_t revision;
+
+    /// Monitor name descriptor (0xfc), or empty.
+    char monitorName[MAX_STRING_LENGTH + 1];
+    /// Monitor serial number descriptor (0xff), or empty.
+    char serialString[MAX_STRING_LENGTH + 1];
+
+    /// Detailed timings in block order. The first one from the base block
+    /// is the preferred timing.
+    DetailedTiming detailedTimings[MAX_DETAILED_TIMINGS];
+    std::size_t detailedTimingCount;
+    bool hasPreferredTiming;
+
+    /// Extension blocks announced by the base block.
+    std::size_t extensionCount;
+    /// CTA-861 extension blocks that passed their checksum and were parsed.
+    std::size_t ctaExtensionCount;
+
+    /// CTA-861 short video descriptors (VICs) with the native flag removed.
+    uint8_t videoCodes[MAX_VIDEO_CODES];
+    std::size_t videoCodeCount;
+    /// The VIC flagged as native, or 0.
+    uint8_t nativeVideoCode;
+
+    /**
+     * Returns the preferred timing, or nullptr if the base block doesn't
+     * start with a detailed timing.
+     */
+    const DetailedTiming* getPreferredTiming() const;
+};
+
+/**
+ * Parses an EDID blob. Extension blocks that are missing, fail their
+ * checksum or aren't CTA-861 are skipped; only a damaged base block fails.
+ *
+ * @param data the raw EDID, usually a multiple of 128 bytes.
+ * @param size the number of bytes at @p data.
+ * @param edid receives the decoded data; reset even on failure.
+ */
+EDIDStatus parseEDID(const uint8_t* data, std::size_t size, EDID& edid);
+
+} // end namespace display
+} // end namespace osvr
+
+#endif // INCLUDED_EDID_h_GUID_7F8A4FF9_99FD_4313_AECE_0FCC3C40DB98
@@ -0,0 +1,131 @@
+/** @file
+    @brief Stand-ins for the SteamVR server driver host and its settings.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_StubDriverHost_h_GUID_5E0C7B3A_91D4_4F26_A8E2_3C6D1B7F9042
+#define INCLUDED_StubDriverHost_h_GUID_5E0C7B3A_91D4_4F26_A8E2_3C6D1B7F9042
+
+// Internal Includes
+#include <osvr_compiler_detection.h>
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+// Standard includes
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace test {
+
+/**
+ * Answers every setting with its default unless a test overrode it. Set the
+ * overrides before constructing the device that reads them.
+ */
+class StubSettings : public vr::IVRSettings {
+public:
+    void setBool(const std::string& key, bool value)
+    {
+        bools_[key] = value;
+    }
+
+    void setInt32(const std::string& key, int32_t value)
+    {
+        int32s_[key] = value;
+    }
+
+    const char* GetSettingsErrorNameFromEnum(vr::EVRSettingsError) OSVR_OVERRIDE { return ""; }
+    bool Sync(bool, vr::EVRSettingsError*) OSVR_OVERRIDE { return true; }
+
+    bool GetBool(const char*, const char* key, bool default_value, vr::EVRSettingsError*) OSVR_OVERRIDE
+    {
+        const auto value = bools_.find(key);
+        return (bools_.end() == value) ? default_value : value->second;
+    }
+
+    void SetBool(const char*, const char*, bool, vr::EVRSettingsError*) OSVR_OVERRIDE {}
+    int32_t GetInt32(const char*, const char* key, int32_t default_value, vr::EVRSettingsError*) OSVR_OVERRIDE
+    {
+        const auto value = int32s_.find(key);
+        return (int32s_.end() == value) ? default_value : value->second;
+    }
+
+    void SetInt32(const char*, const char*, int32_t, vr::EVRSettingsError*) OSVR_OVERRIDE {}
+    float GetFloat(const char*, const char*, float default_value, vr::EVRSettingsError*) OSVR_OVERRIDE { return default_value; }
+    void SetFloat(const char*, const char*, float, vr::EVRSettingsError*) OSVR_OVERRIDE {}
+
+    void GetString(const char*, const char*, char* value, uint32_t value_length, const char* default_value, vr::EVRSettingsError*) OSVR_OVERRIDE
+    {
+        if (value_length > 0) {
+            std::strncpy(value, default_value, value_length - 1);
+            value[value_length - 1] = '\0';
+        }
+    }
+
+    void SetString(const char*, const char*, const char*, vr::EVRSettingsError*) OSVR_OVERRIDE {}
+    void RemoveSection(const char*, vr::EVRSettingsError*) OSVR_OVERRIDE {}
+    void RemoveKeyInSection(const char*, const char*, vr::EVRSettingsError*) OSVR_OVERRIDE {}
+
+private:
+    std::map<std::string, bool> bools_;
+    std::map<std::string, int32_t> int32s_;
+};
+
+/**
+ * Ignores everything a device tells SteamVR. Tests override the calls they
+ * want to check.
+ */
+class StubDriverHost : public vr::IServerDriverHost {
+public:
+    StubSettings& settings()
+    {
+        return settings_;
+    }
+
+    vr::IVRSettings* GetSettings(const char*) OSVR_OVERRIDE { return &settings_; }
+
+    bool TrackedDeviceAdded(const char*) OSVR_OVERRIDE { return true; }
+    void TrackedDevicePoseUpdated(uint32_t, const vr::DriverPose_t&) OSVR_OVERRIDE {}
+    void TrackedDevicePropertiesChanged(uint32_t) OSVR_OVERRIDE {}
+    void VsyncEvent(double) OSVR_OVERRIDE {}
+    void TrackedDeviceButtonPressed(uint32_t, vr::EVRButtonId, double) OSVR_OVERRIDE {}
+    void TrackedDeviceButtonUnpressed(uint32_t, vr::EVRButtonId, double) OSVR_OVERRIDE {}
+    void TrackedDeviceButtonTouched(uint32_t, vr::EVRButtonId, double) OSVR_OVERRIDE {}
+    void TrackedDeviceButtonUntouched(uint32_t, vr::EVRButtonId, double) OSVR_OVERRIDE {}
+    void TrackedDeviceAxisUpdated(uint32_t, uint32_t, const vr::VRControllerAxis_t&) OSVR_OVERRIDE {}
+    void MCImageUpdated() OSVR_OVERRIDE {}
+    void PhysicalIpdSet(uint32_t, float) OSVR_OVERRIDE {}
+    void ProximitySensorState(uint32_t, bool) OSVR_OVERRIDE {}
+    void VendorSpecificEvent(uint32_t, vr::EVREventType, const vr::VREvent_Data_t&, double) OSVR_OVERRIDE {}
+    bool IsExiting() OSVR_OVERRIDE { return false; }
+    bool PollNextEvent(vr::VREvent_t*, uint32_t) OSVR_OVERRIDE { return false; }
+
+private:
+    StubSettings settings_;
+};
+
+} // end namespace test
+
+#endif // INCLUDED_StubDriverHost_h_GUID_5E0C7B3A_91D4_4F26_A8E2_3C6D1B7F9042
@@ -0,0 +1,83 @@
+/** @file
+    @brief Minimal check helpers shared by the unit tests.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_TestHelpers_h_GUID_67B985AA_08BF_4D5C_8755_82ECCB251866
+#define INCLUDED_TestHelpers_h_GUID_67B985AA_08BF_4D5C_8755_82ECCB251866
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace test {
+
+/// The number of failed checks so far.
+inline int& failures()
+{
+    static int count = 0;
+    return count;
+}
+
+/**
+ * Reports @p description if @p condition doesn't hold. Tests keep going after
+ * a failed check so one run reports every failure.
+ */
+inline void check(bool condition, const std::string& description)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << description << std::endl;
+        ++failures();
+    }
+}
+
+inline bool near(double a, double b, double tolerance = 1e-6)
+{
+    return std::abs(a - b) < tolerance;
+}
+
+/**
+ * Prints a summary and returns the exit code for main().
+ */
+inline int finish()
+{
+    if (failures()) {
+        std::cerr << failures() << " check(s) failed." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return EXIT_SUCCESS;
+}
+
+} // end namespace test
+
+#endif // INCLUDED_TestHelpers_h_GUID_67B985AA_08BF_4D5C_8755_82ECCB251866
@@ -0,0 +1,228 @@
+/** @file
+    @brief Tests that controller button and axis events reach SteamVR in the
+    order they arrived.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <OSVRTrackedController.h>
+#include <osvr_compiler_detection.h>
+#include "StubDriverHost.h"
+#include "TestHelpers.h"
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+#include <osvr/ClientKit/Context.h>
+#include <osvr/Util/ClientReportTypesC.h>
+#include <osvr/Util/TimeValueC.h>
+
+// Standard includes
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using test::check;
+
+const uint32_t TRIGGER_AXIS = 1;
+const uint32_t JOYSTICK_AXIS = 2;
+
+/**
+ * Records what the controller sends SteamVR, one line per call.
+ */
+class RecordingHost : public test::StubDriverHost {
+public:
+    void TrackedDeviceButtonPressed(uint32_t, vr::EVRButtonId button, double) OSVR_OVERRIDE
+    {
+        record("press " + std::to_string(button));
+    }
+
+    void TrackedDeviceButtonUnpressed(uint32_t, vr::EVRButtonId button, double) OSVR_OVERRIDE
+    {
+        record("release " + std::to_string(button));
+    }
+
+    void TrackedDeviceAxisUpdated(uint32_t, uint32_t axis, const vr::VRControllerAxis_t& axis_state) OSVR_OVERRIDE
+    {
+        std::ostringstream event;
+        event << "axis " << axis << " " << axis_state.x << " " << axis_state.y;
+        record(event.str());
+    }
+
+    /**
+     * Returns the calls since the last time and forgets them.
+     */
+    std::vector<std::string> takeEvents()
+    {
+        std::vector<std::string> events;
+        events.swap(events_);
+        return events;
+    }
+
+private:
+    void record(const std::string& event)
+    {
+        events_.push_back(event);
+    }
+
+    std::vector<std::string> events_;
+};
+
+/**
+ * Feeds the controller's callbacks directly, the way its OSVR interfaces
+ * would.
+ */
+class TestController : public OSVRTrackedController {
+public:
+    TestController(osvr::clientkit::ClientContext& context, vr::IServerDriverHost* driver_host) : OSVRTrackedController(context, driver_host, 0)
+    {
+        initAxis(trigger_, TRIGGER_AXIS, vr::k_eControllerAxis_Trigger);
+        initAxis(joystick_, JOYSTICK_AXIS, vr::k_eControllerAxis_Joystick);
+    }
+
+    void button(int32_t sensor, bool pressed)
+    {
+        OSVR_ButtonReport report;
+        report.sensor = sensor;
+        report.state = pressed ? OSVR_BUTTON_PRESSED : OSVR_BUTTON_NOT_PRESSED;
+        controllerButtonCallback(this, &timestamp_, &report);
+    }
+
+    void trigger(double value)
+    {
+        controllerTriggerCallback(&trigger_, &timestamp_, makeAnalogReport(value));
+    }
+
+    void joystick(double x, double y)
+    {
+        controllerJoystickXCallback(&joystick_, &timestamp_, makeAnalogReport(x));
+        controllerJoystickYCallback(&joystick_, &timestamp_, makeAnalogReport(y));
+    }
+
+private:
+    void initAxis(AnalogInterface& analog_interface, uint32_t axis_index, vr::EVRControllerAxisType axis_type)
+    {
+        analog_interface.parentController = this;
+        analog_interface.axisType = axis_type;
+        analog_interface.x = 0.0;
+        analog_interface.y = 0.0;
+        analog_interface.axisIndex = axis_index;
+    }
+
+    const OSVR_AnalogReport* makeAnalogReport(double value)
+    {
+        analogReport_.sensor = 0;
+        analogReport_.state = value;
+        return &analogReport_;
+    }
+
+    OSVR_TimeValue timestamp_ = {};
+    OSVR_AnalogReport analogReport_;
+    AnalogInterface trigger_;
+    AnalogInterface joystick_;
+};
+
+bool sent(RecordingHost& host, const std::vector<std::string>& expected)
+{
+    const auto events = host.takeEvents();
+    if (events == expected)
+        return true;
+
+    std::cerr << "Sent:";
+    for (const auto& event : events) {
+        std::cerr << " [" << event << "]";
+    }
+    std::cerr << std::endl;
+    return false;
+}
+
+void testMixedOrder(osvr::clientkit::ClientContext& context)
+{
+    RecordingHost host;
+    TestController controller(context, &host);
+
+    controller.button(1, true);
+    controller.trigger(0.5);
+    controller.button(1, false);
+    controller.trigger(0.75);
+    check(sent(host, {}), "mixed order: nothing is sent before the frame");
+
+    controller.runFrame(false);
+    check(sent(host, { "press 1", "axis 1 0.5 0", "release 1", "axis 1 0.75 0" }), "mixed order: events are sent in arrival order");
+
+    controller.runFrame(false);
+    check(sent(host, {}), "mixed order: events are sent once");
+}
+
+void testAxisCoalescing(osvr::clientkit::ClientContext& context)
+{
+    RecordingHost host;
+    TestController controller(context, &host);
+
+    // Only the newest value of an axis matters until a button changes
+    controller.trigger(0.25);
+    controller.joystick(0.5, -0.5);
+    controller.trigger(0.5);
+    controller.button(2, true);
+    controller.trigger(0.75);
+    controller.runFrame(false);
+    check(sent(host, { "axis 1 0.5 0", "axis 2 0.5 -0.5", "press 2", "axis 1 0.75 0" }), "coalescing: axis updates merge up to a button change");
+}
+
+void testReleaseOnLaterFrame(osvr::clientkit::ClientContext& context)
+{
+    RecordingHost host;
+    TestController controller(context, &host);
+    const auto button_mask = vr::ButtonMaskFromId(static_cast<vr::EVRButtonId>(3));
+
+    controller.button(3, true);
+    controller.runFrame(false);
+    check(sent(host, { "press 3" }), "release: the press is sent");
+    check(0 != (controller.GetControllerState().ulButtonPressed & button_mask), "release: the state shows the button pressed");
+
+    const auto packet_num = controller.GetControllerState().unPacketNum;
+    controller.button(3, false);
+    check(0 == (controller.GetControllerState().ulButtonPressed & button_mask), "release: the state shows the button released right away");
+    check(packet_num != controller.GetControllerState().unPacketNum, "release: the state's packet number changes");
+
+    controller.runFrame(false);
+    check(sent(host, { "release 3" }), "release: the release is sent on the next frame");
+}
+
+} // end anonymous namespace
+
+int main()
+{
+    // Never updated: the callbacks are fed directly
+    osvr::clientkit::ClientContext context("org.osvr.test.controller");
+
+    testMixedOrder(context);
+    testAxisCoalescing(context);
+    testReleaseOnLaterFrame(context);
+
+    return test::finish();
+}
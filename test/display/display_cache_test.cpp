@@ -0,0 +1,265 @@
+/** @file
+    @brief Tests for DisplayCache and the display hotplug uevent filter.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <display/DisplayCache.h>
+#include <display/DisplayHotplugMonitor.h>
+#include "TestHelpers.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using test::check;
+using osvr::display::Display;
+using osvr::display::DisplayCache;
+using osvr::display::DisplayHotplugMonitor;
+
+class FakeMonitor : public DisplayHotplugMonitor {
+public:
+    explicit FakeMonitor(bool& pending) : pending_(pending) {}
+
+    virtual bool poll() override
+    {
+        const auto pending = pending_;
+        pending_ = false;
+        return pending;
+    }
+
+private:
+    bool& pending_;
+};
+
+struct FakeDisplays {
+    std::vector<Display> displays;
+    int enumerations = 0;
+
+    DisplayCache::Enumerator enumerator()
+    {
+        return [this] {
+            ++enumerations;
+            return displays;
+        };
+    }
+};
+
+Display makeDisplay(const std::string& name)
+{
+    Display display = {};
+    display.name = name;
+    display.size.width = 1920;
+    display.size.height = 1080;
+    display.verticalRefreshRate = {60, 1};
+    return display;
+}
+
+/**
+ * Polls until the cache has refreshed @p refreshes times in all, and returns
+ * whether any of those polls reported a change.
+ */
+bool pollUntilRefreshed(DisplayCache& cache, uint64_t refreshes)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    bool changed = false;
+    while (cache.getRefreshCount() < refreshes && std::chrono::steady_clock::now() < deadline) {
+        changed = cache.poll() || changed;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return changed;
+}
+
+void testSnapshotsAreReused()
+{
+    FakeDisplays fake;
+    fake.displays.push_back(makeDisplay("OSVR HDK"));
+    DisplayCache cache(DisplayCache::Clock::duration::zero(), fake.enumerator(), nullptr);
+
+    const auto first = cache.getDisplays();
+    const auto second = cache.getDisplays();
+    check(1 == fake.enumerations, "displays are enumerated once");
+    check(first == second, "the same snapshot is returned until something changes");
+    check(1 == first->size() && "OSVR HDK" == first->front().name, "the snapshot holds the enumerated displays");
+    check(DisplayCache::Refresh::Initial == cache.getLastRefresh(), "the first refresh is reported as initial");
+}
+
+void testInvalidate()
+{
+    FakeDisplays fake;
+    fake.displays.push_back(makeDisplay("OSVR HDK"));
+    DisplayCache cache(DisplayCache::Clock::duration::zero(), fake.enumerator(), nullptr);
+
+    const auto before = cache.getDisplays();
+    fake.displays.push_back(makeDisplay("Desktop"));
+    cache.invalidate();
+    const auto after = cache.getDisplays();
+
+    check(2 == fake.enumerations, "invalidate() causes one more enumeration");
+    check(1 == before->size(), "earlier snapshots are never modified");
+    check(2 == after->size(), "the new snapshot holds the new displays");
+    check(DisplayCache::Refresh::Requested == cache.getLastRefresh(), "the refresh is reported as requested");
+}
+
+void testHotplug()
+{
+    FakeDisplays fake;
+    fake.displays.push_back(makeDisplay("OSVR HDK"));
+    bool hotplug = false;
+    DisplayCache cache(DisplayCache::Clock::duration::zero(), fake.enumerator(), std::unique_ptr<DisplayHotplugMonitor>(new FakeMonitor(hotplug)));
+    check(cache.hasHotplugMonitor(), "the cache uses the supplied monitor");
+
+    check(cache.poll(), "the first poll reports the initial displays");
+    check(!cache.poll(), "polling without a notification changes nothing");
+    check(1 == fake.enumerations, "polling without a notification doesn't enumerate");
+
+    // A notification that doesn't change the displays
+    hotplug = true;
+    check(!pollUntilRefreshed(cache, 2), "a notification with the same displays isn't a change");
+    check(2 == fake.enumerations, "a notification causes an enumeration");
+    check(DisplayCache::Refresh::Hotplug == cache.getLastRefresh(), "the refresh is reported as a hotplug");
+
+    fake.displays.clear();
+    hotplug = true;
+    check(pollUntilRefreshed(cache, 3), "a notification with different displays is a change");
+    check(cache.getDisplays()->empty(), "the snapshot reflects the disconnected display");
+}
+
+void testHotplugDoesNotBlock()
+{
+    // Every enumeration after the first waits until it's released
+    std::promise<void> release;
+    const auto released = release.get_future().share();
+    std::atomic<int> enumerations(0);
+    bool hotplug = false;
+    DisplayCache cache(DisplayCache::Clock::duration::zero(), [&enumerations, released] {
+        if (enumerations++ > 0)
+            released.wait();
+        return std::vector<Display>();
+    }, std::unique_ptr<DisplayHotplugMonitor>(new FakeMonitor(hotplug)));
+
+    const auto first = cache.getDisplays();
+    hotplug = true;
+    check(!cache.poll(), "poll() doesn't wait for a notification's enumeration");
+    check(first == cache.getDisplays(), "the old snapshot is used until the new one is ready");
+
+    // The enumeration already running may have missed this one
+    hotplug = true;
+    check(!cache.poll(), "a second notification doesn't wait either");
+    release.set_value();
+
+    pollUntilRefreshed(cache, 3);
+    check(3 == cache.getRefreshCount(), "a notification during an enumeration causes another one");
+    check(3 == enumerations, "each enumeration runs once");
+}
+
+void testTimeToLive()
+{
+    FakeDisplays fake;
+    DisplayCache cache(std::chrono::milliseconds(1), fake.enumerator(), nullptr);
+
+    cache.getDisplays();
+    fake.displays.push_back(makeDisplay("OSVR HDK"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // The refresh happens in the background and shows up in a later poll
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    bool changed = false;
+    while (!changed && std::chrono::steady_clock::now() < deadline) {
+        changed = cache.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    check(changed, "an expired snapshot is enumerated again");
+    check(1 == cache.getDisplays()->size(), "the new snapshot holds the new displays");
+    check(DisplayCache::Refresh::Expired == cache.getLastRefresh(), "the refresh is reported as expired");
+}
+
+void testExpiryDoesNotBlock()
+{
+    // Every enumeration after the first waits until it's released
+    std::promise<void> release;
+    const auto released = release.get_future().share();
+    std::atomic<int> enumerations(0);
+    DisplayCache cache(std::chrono::milliseconds(1), [&enumerations, released] {
+        if (enumerations++ > 0)
+            released.wait();
+        return std::vector<Display>();
+    }, nullptr);
+
+    const auto first = cache.getDisplays();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    check(!cache.poll(), "poll() doesn't wait for an expired snapshot to be enumerated");
+    check(first == cache.getDisplays(), "the expired snapshot is used until the new one is ready");
+    check(1 == cache.getRefreshCount(), "the expired snapshot hasn't been replaced yet");
+    release.set_value();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (cache.getRefreshCount() < 2 && std::chrono::steady_clock::now() < deadline) {
+        cache.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    check(2 == cache.getRefreshCount(), "a later poll() picks up the background enumeration");
+}
+
+void testUeventFilter()
+{
+    using osvr::display::isDisplayUevent;
+
+    const char drm[] = "change@/devices/pci0000:00/0000:00:02.0/drm/card0\0ACTION=change\0DEVPATH=/devices/pci0000:00/0000:00:02.0/drm/card0\0SUBSYSTEM=drm\0HOTPLUG=1\0";
+    const char usb[] = "add@/devices/pci0000:00/0000:00:14.0/usb1/1-1\0ACTION=add\0SUBSYSTEM=usb\0";
+    const char prefix[] = "change@/x\0SUBSYSTEM=drm_dp_aux_dev\0";
+    const char truncated[] = "change@/x\0SUBSYSTEM=dr";
+
+    check(isDisplayUevent(drm, sizeof(drm) - 1), "DRM uevents are recognized");
+    check(!isDisplayUevent(usb, sizeof(usb) - 1), "other subsystems are ignored");
+    check(!isDisplayUevent(prefix, sizeof(prefix) - 1), "subsystems that start with drm are ignored");
+    check(!isDisplayUevent(truncated, sizeof(truncated) - 1), "truncated fields are ignored");
+    check(!isDisplayUevent(drm, 0), "empty messages are ignored");
+}
+
+} // end anonymous namespace
+
+int main()
+{
+    testSnapshotsAreReused();
+    testInvalidate();
+    testHotplug();
+    testHotplugDoesNotBlock();
+    testTimeToLive();
+    testExpiryDoesNotBlock();
+    testUeventFilter();
+
+    return test::finish();
+}
@@ -0,0 +1,140 @@
+/** @file
+    @brief Tests for the Linux DRM sysfs display enumerator.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <display/DisplayEnumerator.h>
+#include "TestHelpers.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using test::check;
+using test::near;
+using osvr::display::Display;
+using osvr::display::RefreshRate;
+using osvr::display::Rotation;
+
+void testConnectedDisplays(const std::vector<Display>& displays)
+{
+    // card0-DP-2 is disconnected; card0, card1, renderD128 and version aren't
+    // connectors.
+    check(3 == displays.size(), "only connected connectors are enumerated");
+    if (3 != displays.size())
+        return;
+
+    // Connectors are listed in name order.
+    check("SYNTH DESK" == displays[0].name, "card0-DP-1 comes first");
+    check("SYNTH CTA" == displays[1].name, "card0-HDMI-A-1 comes second");
+    check("VGA-1" == displays[2].name, "card1-VGA-1 comes last");
+}
+
+void testHMD(const Display& hmd)
+{
+    check("card0 i915 [8086:1912]" == hmd.adapter.description, "the adapter is described by its card, driver and PCI ID");
+    check(2160 == hmd.size.width && 1200 == hmd.size.height, "the resolution comes from the preferred timing");
+    check(0 == hmd.position.x && 0 == hmd.position.y, "the position is unknown");
+    check(Rotation::Zero == hmd.rotation, "the rotation is unknown");
+    // 249.98 MHz / (2240 * 1240)
+    check((RefreshRate{249980000, 2777600}) == hmd.verticalRefreshRate, "the refresh rate is the pixel clock over the totals");
+    check(near(249980000.0 / 2777600.0, hmd.verticalRefreshRate.hertz()), "the refresh rate isn't rounded");
+    check(!hmd.attachedToDesktop, "a disabled connector is available for direct mode");
+    check(0xd24e == hmd.edidVendorId, "the vendor ID matches the Windows encoding");
+    check(0x1019 == hmd.edidProductId, "the product ID is little-endian");
+}
+
+void testDesktopMonitor(const Display& monitor)
+{
+    check(1920 == monitor.size.width && 1200 == monitor.size.height, "the resolution comes from the preferred timing");
+    // 154.00 MHz / (2080 * 1235)
+    check(near(154000000.0 / 2568800.0, monitor.verticalRefreshRate.hertz()), "the refresh rate comes from the pixel clock and totals");
+    check(monitor.attachedToDesktop, "an enabled connector is attached to the desktop");
+    check(0xac10 == monitor.edidVendorId, "the vendor ID matches the Windows encoding");
+    check(0xa0c4 == monitor.edidProductId, "the product ID is little-endian");
+}
+
+void testMissingEDID(const Display& display)
+{
+    check("card1 nouveau [10DE:13C2]" == display.adapter.description, "each card is described separately");
+    check(1024 == display.size.width && 768 == display.size.height, "the resolution falls back on the first mode");
+    check(near(60.0, display.verticalRefreshRate.hertz()), "the refresh rate falls back on 60 Hz");
+    check(0 == display.edidVendorId && 0 == display.edidProductId, "there are no EDID IDs");
+}
+
+void testDesktopState(const std::vector<Display>& displays)
+{
+    // The HMD as it was detected while it was extending the desktop, at a
+    // different mode.
+    auto hmd = displays[1];
+    hmd.attachedToDesktop = true;
+    hmd.size = {1920, 1080};
+    hmd.verticalRefreshRate = {60, 1};
+    check(!osvr::display::isAttachedToDesktop(displays, hmd), "a disabled HMD isn't on the desktop");
+
+    // The HMD as it was detected in direct mode, after it's been enabled.
+    auto enabled = displays;
+    enabled[1].attachedToDesktop = true;
+    check(osvr::display::isAttachedToDesktop(enabled, displays[1]), "an HMD that was enabled later is on the desktop");
+
+    auto other = displays[1];
+    other.edidProductId = 0x1234;
+    check(!osvr::display::isAttachedToDesktop(enabled, other), "a different product doesn't match");
+
+    check(!osvr::display::isAttachedToDesktop({}, displays[0]), "a display that's gone isn't on the desktop");
+}
+
+void testMissingTree()
+{
+    check(osvr::display::getDisplaysFromSysfs("/nonexistent/class/drm").empty(), "a missing sysfs tree has no displays");
+}
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <fixture sysfs class/drm directory>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto displays = osvr::display::getDisplaysFromSysfs(argv[1]);
+    testConnectedDisplays(displays);
+    if (3 == displays.size()) {
+        testDesktopMonitor(displays[0]);
+        testHMD(displays[1]);
+        testMissingEDID(displays[2]);
+        testDesktopState(displays);
+    }
+    testMissingTree();
+
+    return test::finish();
+}
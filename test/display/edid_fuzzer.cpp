@@ -0,0 +1,54 @@
+/** @file
+    @brief libFuzzer entry point for the EDID parser.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <display/EDID.h>
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size)
+{
+    osvr::display::EDID edid;
+    if (osvr::display::EDIDStatus::Success != osvr::display::parseEDID(data, size, edid))
+        return 0;
+
+    // Touch everything the enumerators read so the sanitizers see it.
+    volatile std::size_t sink = std::strlen(edid.monitorName) + std::strlen(edid.serialString) + std::strlen(edid.manufacturer);
+    for (std::size_t i = 0; i < edid.detailedTimingCount; ++i) {
+        volatile double refresh_rate = edid.detailedTimings[i].refreshRate().hertz();
+        (void)refresh_rate;
+    }
+    for (std::size_t i = 0; i < edid.videoCodeCount; ++i)
+        sink = sink + edid.videoCodes[i];
+    (void)sink;
+
+    return 0;
+}
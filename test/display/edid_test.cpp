@@ -0,0 +1,240 @@
+/** @file
+    @brief Tests for the EDID parser against a corpus of EDIDs.
+
+    The corpus is synthetic: each blob was built by hand to exercise part of
+    the parser (a CTA-861 extension, a 13-character serial string, damaged
+    checksums, ...), not captured from a real display. The expected values
+    come from the EDID layout, not from the parser's own output.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <display/EDID.h>
+#include "TestHelpers.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+using test::check;
+using test::near;
+using osvr::display::DetailedTiming;
+using osvr::display::EDID;
+using osvr::display::EDIDStatus;
+using osvr::display::parseEDID;
+using osvr::display::RefreshRate;
+
+std::string corpus_path;
+
+std::vector<uint8_t> load(const std::string& name)
+{
+    std::ifstream file(corpus_path + "/" + name, std::ios::binary);
+    if (!file)
+        check(false, "corpus file " + name + " exists");
+
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+EDIDStatus parse(const std::vector<uint8_t>& data, EDID& edid)
+{
+    return parseEDID(data.data(), data.size(), edid);
+}
+
+void testSingleTiming()
+{
+    EDID edid;
+    check(EDIDStatus::Success == parse(load("synthetic_single_timing.bin"), edid), "single timing: parses");
+    check(0 == std::strcmp("SVR", edid.manufacturer), "single timing: manufacturer");
+    check(0xd24e == edid.vendorId, "single timing: vendor ID matches the Windows encoding");
+    check(0x1019 == edid.productId, "single timing: product ID");
+    check(1 == edid.version && 3 == edid.revision, "single timing: EDID 1.3");
+    check(2015 == edid.manufactureYear && 12 == edid.manufactureWeek, "single timing: manufacture date");
+    check(0 == std::strcmp("SYNTH 60", edid.monitorName), "single timing: monitor name without padding");
+    check('\0' == edid.serialString[0], "single timing: no serial string");
+    check(0 == edid.extensionCount && 0 == edid.ctaExtensionCount, "single timing: no extensions");
+    check(1 == edid.detailedTimingCount, "single timing: display descriptors aren't timings");
+
+    const auto timing = edid.getPreferredTiming();
+    check(nullptr != timing, "single timing: has a preferred timing");
+    if (!timing)
+        return;
+
+    check(148500000 == timing->pixelClock, "single timing: pixel clock");
+    check(1920 == timing->horizontalActive && 1080 == timing->verticalActive, "single timing: active area");
+    check(2200 == timing->horizontalTotal() && 1125 == timing->verticalTotal(), "single timing: totals");
+    check(88 == timing->horizontalSyncOffset && 44 == timing->horizontalSyncWidth, "single timing: horizontal sync");
+    check(4 == timing->verticalSyncOffset && 5 == timing->verticalSyncWidth, "single timing: vertical sync");
+    check(121 == timing->widthMillimeters && 68 == timing->heightMillimeters, "single timing: image size");
+    check(!timing->interlaced, "single timing: progressive");
+    check(near(60.0, timing->refreshRate().hertz()), "single timing: 60 Hz");
+    check((RefreshRate{60, 1}) == timing->refreshRate(), "single timing: exactly 60 Hz");
+}
+
+void testCTAExtension()
+{
+    EDID edid;
+    check(EDIDStatus::Success == parse(load("synthetic_cta861_ext.bin"), edid), "CTA-861 extension: parses");
+    check(0 == std::strcmp("SYNTH CTA", edid.monitorName), "CTA-861 extension: monitor name");
+    check(0 == std::strcmp("SYN00001", edid.serialString), "CTA-861 extension: serial string");
+    check(1 == edid.extensionCount && 1 == edid.ctaExtensionCount, "CTA-861 extension: one CTA-861 extension");
+    check(2 == edid.detailedTimingCount, "CTA-861 extension: timings from both blocks");
+    check(1 == edid.videoCodeCount && 16 == edid.videoCodes[0], "CTA-861 extension: VIC 16 without the native flag");
+    check(16 == edid.nativeVideoCode, "CTA-861 extension: VIC 16 is native");
+
+    const auto timing = edid.getPreferredTiming();
+    check(nullptr != timing, "CTA-861 extension: has a preferred timing");
+    if (timing) {
+        check(2160 == timing->horizontalActive && 1200 == timing->verticalActive, "CTA-861 extension: active area");
+        check(249980000 == timing->refreshRate().numerator && 2777600 == timing->refreshRate().denominator, "CTA-861 extension: refresh rate is the pixel clock over the totals");
+        check(near(249980000.0 / (2240.0 * 1240.0), timing->refreshRate().hertz()), "CTA-861 extension: refresh rate isn't rounded to 90 Hz");
+    }
+
+    if (2 == edid.detailedTimingCount)
+        check(near(166650000.0 / (2240.0 * 1240.0), edid.detailedTimings[1].refreshRate().hertz()), "CTA-861 extension: the CTA-861 timing is the 60 Hz fallback");
+}
+
+void testNoMonitorName()
+{
+    EDID edid;
+    check(EDIDStatus::Success == parse(load("synthetic_no_monitor_name.bin"), edid), "no monitor name: parses");
+    check(0 == std::strcmp("HVR", edid.manufacturer), "no monitor name: manufacturer");
+    check(0xaa01 == edid.productId, "no monitor name: product ID");
+    check(0x1234 == edid.serialNumber, "no monitor name: serial number");
+    check('\0' == edid.monitorName[0], "no monitor name: no monitor name");
+
+    const auto timing = edid.getPreferredTiming();
+    check(nullptr != timing, "no monitor name: has a preferred timing");
+    if (timing)
+        check(near(297000000.0 / (2336.0 * 1420.0), timing->refreshRate().hertz()), "no monitor name: 89.53 Hz");
+}
+
+void testPortraitSerialString()
+{
+    EDID edid;
+    check(EDIDStatus::Success == parse(load("synthetic_portrait_serial_string.bin"), edid), "portrait: parses");
+    check(0 == std::strcmp("PORTRAIT", edid.monitorName), "portrait: monitor name");
+    check(0 == std::strcmp("SYNABCDEFGHIJ", edid.serialString), "portrait: 13-character serial string without a terminator");
+
+    const auto timing = edid.getPreferredTiming();
+    check(nullptr != timing, "portrait: has a preferred timing");
+    if (timing)
+        check(1080 == timing->horizontalActive && 1920 == timing->verticalActive, "portrait: portrait panel");
+}
+
+void testRefreshRate()
+{
+    const RefreshRate unknown = {0, 0};
+    check(0.0 == unknown.hertz() && 0.0 == unknown.period(), "an unknown refresh rate is 0 Hz");
+    check((RefreshRate{148500000, 2475000}) == (RefreshRate{60, 1}), "equal ratios compare equal");
+    check((RefreshRate{249980000, 2777600}) != (RefreshRate{90, 1}), "89.9986 Hz isn't 90 Hz");
+    check(unknown != (RefreshRate{60, 1}), "an unknown refresh rate isn't 60 Hz");
+    check(near(2777600.0 / 249980000.0, (RefreshRate{249980000, 2777600}).period()), "the period is the inverse");
+}
+
+void testDamagedBlobs()
+{
+    EDID edid;
+    check(EDIDStatus::BadChecksum == parse(load("bad_checksum.bin"), edid), "a bad base checksum fails");
+    check(EDIDStatus::TooShort == parse(load("truncated.bin"), edid), "a truncated base block fails");
+    check(EDIDStatus::TooShort == parseEDID(nullptr, 0, edid), "no data fails");
+
+    auto data = load("synthetic_single_timing.bin");
+    data[0] = 0xff;
+    check(EDIDStatus::BadHeader == parse(data, edid), "a missing header fails");
+
+    check(EDIDStatus::Success == parse(load("bad_extension_checksum.bin"), edid), "a bad extension checksum doesn't fail");
+    check(0 == edid.ctaExtensionCount && 1 == edid.detailedTimingCount, "a bad extension is skipped");
+
+    // The base block announces an extension that isn't there.
+    data = load("synthetic_cta861_ext.bin");
+    data.resize(EDID::BLOCK_SIZE);
+    check(EDIDStatus::Success == parse(data, edid), "a missing extension doesn't fail");
+    check(1 == edid.extensionCount && 0 == edid.ctaExtensionCount, "a missing extension is skipped");
+}
+
+void fixChecksum(std::vector<uint8_t>& data, std::size_t block)
+{
+    uint8_t sum = 0;
+    for (std::size_t i = 0; i < EDID::BLOCK_SIZE - 1; ++i)
+        sum = static_cast<uint8_t>(sum + data[block * EDID::BLOCK_SIZE + i]);
+    data[block * EDID::BLOCK_SIZE + EDID::BLOCK_SIZE - 1] = static_cast<uint8_t>(0x100 - sum);
+}
+
+void testMalformedCTA()
+{
+    EDID edid;
+    auto data = load("synthetic_cta861_ext.bin");
+    if (data.size() != 2 * EDID::BLOCK_SIZE)
+        return;
+
+    // An offset of zero means no data blocks and no timings.
+    data[EDID::BLOCK_SIZE + 2] = 0;
+    fixChecksum(data, 1);
+    check(EDIDStatus::Success == parse(data, edid), "CTA-861 without timings parses");
+    check(1 == edid.detailedTimingCount && 0 == edid.videoCodeCount, "CTA-861 without timings adds nothing");
+
+    // An offset inside the block header is invalid.
+    data[EDID::BLOCK_SIZE + 2] = 2;
+    fixChecksum(data, 1);
+    check(EDIDStatus::Success == parse(data, edid), "CTA-861 with a bad offset parses");
+    check(1 == edid.detailedTimingCount && 0 == edid.videoCodeCount, "CTA-861 with a bad offset adds nothing");
+
+    // A data block that runs past the timings is ignored.
+    data = load("synthetic_cta861_ext.bin");
+    data[EDID::BLOCK_SIZE + 4] = 0x5f;
+    fixChecksum(data, 1);
+    check(EDIDStatus::Success == parse(data, edid), "CTA-861 with an overlong data block parses");
+    check(0 == edid.videoCodeCount && 2 == edid.detailedTimingCount, "an overlong data block is ignored");
+}
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <EDID corpus directory>" << std::endl;
+        return EXIT_FAILURE;
+    }
+    corpus_path = argv[1];
+
+    testSingleTiming();
+    testCTAExtension();
+    testNoMonitorName();
+    testPortraitSerialString();
+    testRefreshRate();
+    testDamagedBlobs();
+    testMalformedCTA();
+
+    return test::finish();
+}
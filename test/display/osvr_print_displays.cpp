@@ -24,13 +24,18 @@
 // limitations under the License.
 
 // Internal Includes
+#include <display/DisplayCache.h>
 #include <display/DisplayEnumerator.h>
 
 // Library/third-party includes
 // - none
 
 // Standard includes
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 inline std::string to_string(osvr::display::Rotation rotation)
 {
@@ -46,10 +51,8 @@ inline std::string to_string(osvr::display::Rotation rotation)
     }
 }
 
-int main(int argc, char* argv[])
+void printDisplays(const std::vector<osvr::display::Display>& displays)
 {
-    auto displays = osvr::display::getDisplays();
-
     for (const auto& display : displays) {
         using std::cout;
         using std::endl;
@@ -60,12 +63,53 @@ int main(int argc, char* argv[])
         cout << "  Resolution: " << display.size.width << "x" << display.size.height << endl;
         cout << "  Position: (" << display.position.x << ", " << display.position.y << ")" << endl;
         cout << "  Rotation: " << to_string(display.rotation) << endl;
-        cout << "  Refresh rate: " << display.verticalRefreshRate << endl;
+        cout << "  Refresh rate: " << display.verticalRefreshRate.hertz() << " Hz (" << display.verticalRefreshRate.numerator << "/" << display.verticalRefreshRate.denominator << ")" << endl;
         cout << "  " << (display.attachedToDesktop ? "Extended mode" : "Direct mode") << endl;
         cout << "  EDID vendor ID: 0x" << std::hex << display.edidVendorId << std::dec << endl;
         cout << "  EDID product ID: 0x" << std::hex << display.edidProductId << std::dec << endl;
         cout << "" << endl;
     }
+}
+
+/**
+ * Prints the displays again each time the display cache is refreshed, and
+ * why it was refreshed. Runs until interrupted.
+ */
+int watchDisplays()
+{
+    using osvr::display::DisplayCache;
+    using std::cout;
+    using std::endl;
+
+    DisplayCache cache(std::chrono::seconds(5));
+    cout << "Hotplug notifications " << (cache.hasHotplugMonitor() ? "available" : "unavailable") << "; displays also expire after 5 seconds." << endl;
+    cout << "" << endl;
+
+    printDisplays(*cache.getDisplays());
+
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        const auto refreshes = cache.getRefreshCount();
+        const auto changed = cache.poll();
+        if (cache.getRefreshCount() == refreshes)
+            continue;
+
+        cout << "Refreshed (" << to_string(cache.getLastRefresh()) << "): " << (changed ? "displays changed" : "no change") << endl;
+        if (changed) {
+            cout << "" << endl;
+            printDisplays(*cache.getDisplays());
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && 0 == std::strcmp(argv[1], "--watch")) {
+        return watchDisplays();
+    }
+
+    printDisplays(osvr::display::getDisplays());
 
     return 0;
 }
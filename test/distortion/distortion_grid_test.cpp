@@ -0,0 +1,131 @@
+/** @file
+    @brief Tests for the baked distortion grid lookups.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <DistortionGrid.h>
+#include "TestHelpers.h"
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+// Standard includes
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+using test::check;
+
+const std::size_t RESOLUTION = 8;
+
+/**
+ * A distortion that's linear in u and v, so the bilinear blend reproduces
+ * it exactly. Each channel differs so mixed-up channels are detectable.
+ */
+vr::DistortionCoordinates_t linearDistortion(float u, float v)
+{
+    vr::DistortionCoordinates_t coords;
+    coords.rfRed[0] = u;
+    coords.rfRed[1] = v;
+    coords.rfGreen[0] = 0.5f * u + 0.25f;
+    coords.rfGreen[1] = 1.0f - v;
+    coords.rfBlue[0] = u + v;
+    coords.rfBlue[1] = u - v;
+    return coords;
+}
+
+bool near(const vr::DistortionCoordinates_t& actual, const vr::DistortionCoordinates_t& expected)
+{
+    for (int i = 0; i < 2; ++i) {
+        if (!test::near(actual.rfRed[i], expected.rfRed[i]) || !test::near(actual.rfGreen[i], expected.rfGreen[i]) || !test::near(actual.rfBlue[i], expected.rfBlue[i]))
+            return false;
+    }
+    return true;
+}
+
+DistortionGrid makeGrid()
+{
+    DistortionGrid grid;
+    grid.bake(RESOLUTION, &linearDistortion);
+    return grid;
+}
+
+void testInterior()
+{
+    const auto grid = makeGrid();
+    check(!grid.empty() && RESOLUTION == grid.getResolution(), "interior: the grid is baked");
+    check(near(grid.lookup(0.3f, 0.7f), linearDistortion(0.3f, 0.7f)), "interior: a point inside a cell is interpolated");
+    check(near(grid.lookup(0.5f, 0.5f), linearDistortion(0.5f, 0.5f)), "interior: a node is returned as baked");
+    check(near(grid.lookup(1.0f, 1.0f), linearDistortion(1.0f, 1.0f)), "interior: the far corner belongs to the last cell");
+}
+
+void testOutOfRange()
+{
+    const auto inf = std::numeric_limits<float>::infinity();
+    const auto grid = makeGrid();
+    check(near(grid.lookup(-0.5f, 1.5f), linearDistortion(0.0f, 1.0f)), "out of range: coordinates are clamped to the edge");
+    check(near(grid.lookup(inf, -inf), linearDistortion(1.0f, 0.0f)), "out of range: infinities are clamped to the edge");
+}
+
+void testNaN()
+{
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    const auto grid = makeGrid();
+    check(near(grid.lookup(nan, 0.25f), linearDistortion(0.0f, 0.25f)), "NaN: u is treated as 0");
+    check(near(grid.lookup(0.75f, nan), linearDistortion(0.75f, 0.0f)), "NaN: v is treated as 0");
+    check(near(grid.lookup(nan, nan), linearDistortion(0.0f, 0.0f)), "NaN: both are treated as 0");
+}
+
+void testBatchMatchesScalar()
+{
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    const auto inf = std::numeric_limits<float>::infinity();
+    const auto grid = makeGrid();
+
+    // Enough for two groups of four on the SIMD path and a remainder on the
+    // scalar one, with NaN and out-of-range values in both
+    const std::vector<float> u = { 0.1f, nan, -1.0f, 0.9f, inf, 0.5f, 1.0f, 0.0f, nan };
+    const std::vector<float> v = { 0.2f, 0.4f, nan, 2.0f, 0.6f, -inf, 1.0f, 0.0f, 0.3f };
+    std::vector<vr::DistortionCoordinates_t> coords(u.size());
+    grid.lookup(u.data(), v.data(), u.size(), coords.data());
+
+    for (std::size_t i = 0; i < u.size(); ++i) {
+        check(near(coords[i], grid.lookup(u[i], v[i])), "batch: lookup " + std::to_string(i) + " matches the scalar lookup");
+    }
+}
+
+} // end anonymous namespace
+
+int main()
+{
+    testInterior();
+    testOutOfRange();
+    testNaN();
+    testBatchMatchesScalar();
+
+    return test::finish();
+}
@@ -0,0 +1,172 @@
+/** @file
+    @brief Compares the cost of exact distortion lookups through the
+    RenderManager mesh interpolators with lookups in a baked distortion grid.
+
+    Usage: osvr_distortion_benchmark <display descriptor .json> [lookups]
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <DistortionGrid.h>
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+#include <osvr/RenderKit/DistortionCorrectTextureCoordinate.h>
+#include <osvr/RenderKit/DistortionParameters.h>
+#include <osvr/RenderKit/UnstructuredMeshInterpolator.h>
+#include <osvr/RenderKit/osvr_display_configuration.h>
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using MeshInterpolators = std::vector<std::unique_ptr<osvr::renderkit::UnstructuredMeshInterpolator>>;
+using Clock = std::chrono::steady_clock;
+
+// Mirrors OSVRTrackedHMD::computeExactDistortion().
+vr::DistortionCoordinates_t computeExactDistortion(size_t eye, float u, float v, const osvr::renderkit::DistortionParameters& params, const MeshInterpolators& interpolators)
+{
+    const auto in_coords = osvr::renderkit::Float2 {{u, 1.0f - v}};
+
+    vr::DistortionCoordinates_t coords;
+    const auto red = osvr::renderkit::DistortionCorrectTextureCoordinate(eye, in_coords, params, 0, 1.0f, interpolators);
+    const auto green = osvr::renderkit::DistortionCorrectTextureCoordinate(eye, in_coords, params, 1, 1.0f, interpolators);
+    const auto blue = osvr::renderkit::DistortionCorrectTextureCoordinate(eye, in_coords, params, 2, 1.0f, interpolators);
+    coords.rfRed[0] = red[0];
+    coords.rfRed[1] = 1.0f - red[1];
+    coords.rfGreen[0] = green[0];
+    coords.rfGreen[1] = 1.0f - green[1];
+    coords.rfBlue[0] = blue[0];
+    coords.rfBlue[1] = 1.0f - blue[1];
+    return coords;
+}
+
+double elapsedNanoseconds(Clock::time_point start, size_t count)
+{
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    return static_cast<double>(elapsed) / static_cast<double>(count);
+}
+
+float maxError(const vr::DistortionCoordinates_t& a, const vr::DistortionCoordinates_t& b)
+{
+    float error = 0.0f;
+    for (int i = 0; i < 2; ++i) {
+        error = std::max(error, std::abs(a.rfRed[i] - b.rfRed[i]));
+        error = std::max(error, std::abs(a.rfGreen[i] - b.rfGreen[i]));
+        error = std::max(error, std::abs(a.rfBlue[i] - b.rfBlue[i]));
+    }
+    return error;
+}
+
+int main(int argc, char* argv[])
+{
+    using std::cout;
+    using std::cerr;
+    using std::endl;
+
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <display descriptor .json> [lookups]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file(argv[1]);
+    if (!file) {
+        cerr << "Could not open " << argv[1] << "." << endl;
+        return EXIT_FAILURE;
+    }
+    std::stringstream descriptor;
+    descriptor << file.rdbuf();
+
+    const size_t lookups = (argc > 2) ? static_cast<size_t>(std::strtoul(argv[2], nullptr, 10)) : 100000;
+    const size_t eye = 0;
+
+    OSVRDisplayConfiguration display_configuration(descriptor.str());
+    auto params = osvr::renderkit::DistortionParameters { display_configuration, eye };
+    params.m_desiredTriangles = 200 * 64;
+
+    auto start = Clock::now();
+    MeshInterpolators interpolators;
+    if (!osvr::renderkit::makeUnstructuredMeshInterpolators(params, eye, interpolators)) {
+        cerr << "Could not create mesh interpolators." << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "Built " << interpolators.size() << " mesh interpolators in " << elapsedNanoseconds(start, 1000000) << " ms." << endl;
+
+    // The same random UVs are used for every method
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<float> u(lookups);
+    std::vector<float> v(lookups);
+    for (size_t i = 0; i < lookups; ++i) {
+        u[i] = distribution(generator);
+        v[i] = distribution(generator);
+    }
+
+    std::vector<vr::DistortionCoordinates_t> exact(lookups);
+    start = Clock::now();
+    for (size_t i = 0; i < lookups; ++i) {
+        exact[i] = computeExactDistortion(eye, u[i], v[i], params, interpolators);
+    }
+    cout << "Mesh interpolators: " << elapsedNanoseconds(start, lookups) << " ns/lookup" << endl;
+
+    for (const size_t resolution : { 32, 64, 80, 128 }) {
+        DistortionGrid grid;
+        start = Clock::now();
+        grid.bake(resolution, [&](float s, float t) { return computeExactDistortion(eye, s, t, params, interpolators); });
+        const auto bake_time = elapsedNanoseconds(start, 1000000);
+
+        std::vector<vr::DistortionCoordinates_t> coords(lookups);
+        start = Clock::now();
+        for (size_t i = 0; i < lookups; ++i) {
+            coords[i] = grid.lookup(u[i], v[i]);
+        }
+        const auto single_time = elapsedNanoseconds(start, lookups);
+
+        start = Clock::now();
+        grid.lookup(u.data(), v.data(), lookups, coords.data());
+        const auto batch_time = elapsedNanoseconds(start, lookups);
+
+        float error = 0.0f;
+        for (size_t i = 0; i < lookups; ++i) {
+            error = std::max(error, maxError(exact[i], coords[i]));
+        }
+
+        cout << "Grid " << resolution << "x" << resolution << ": "
+             << single_time << " ns/lookup, "
+             << batch_time << " ns/lookup (batch), "
+             << "baked in " << bake_time << " ms, "
+             << "max error " << error << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
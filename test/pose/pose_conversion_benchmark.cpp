@@ -0,0 +1,147 @@
+/** @file
+    @brief Benchmark for converting OSVR tracker reports to driver poses.
+
+    Compares the shared template-based conversion used by the tracker
+    callbacks against the field-by-field Eigen conversion that each device
+    used to do in its own callback.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <PoseConversion.h>
+#include <matrix_cast.h>
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+#include <osvr/Util/ClientReportTypesC.h>
+#include <osvr/Util/EigenInterop.h>
+
+// Standard includes
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const size_t NUM_REPORTS = 4096;
+const size_t NUM_PASSES = 256;
+
+using Clock = std::chrono::steady_clock;
+
+vr::DriverPose_t legacyConvertPose(const OSVR_PoseReport& report)
+{
+    vr::DriverPose_t pose;
+    pose.poseTimeOffset = 0;
+
+    Eigen::Vector3d::Map(pose.vecWorldFromDriverTranslation) = Eigen::Vector3d::Zero();
+    Eigen::Vector3d::Map(pose.vecDriverFromHeadTranslation) = Eigen::Vector3d::Zero();
+    map(pose.qWorldFromDriverRotation) = Eigen::Quaterniond::Identity();
+    map(pose.qDriverFromHeadRotation) = Eigen::Quaterniond::Identity();
+
+    Eigen::Vector3d::Map(pose.vecPosition) = osvr::util::vecMap(report.pose.translation);
+    Eigen::Vector3d::Map(pose.vecVelocity) = Eigen::Vector3d::Zero();
+    Eigen::Vector3d::Map(pose.vecAcceleration) = Eigen::Vector3d::Zero();
+
+    map(pose.qRotation) = osvr::util::fromQuat(report.pose.rotation);
+    Eigen::Vector3d::Map(pose.vecAngularVelocity) = Eigen::Vector3d::Zero();
+    Eigen::Vector3d::Map(pose.vecAngularAcceleration) = Eigen::Vector3d::Zero();
+
+    pose.result = vr::TrackingResult_Running_OK;
+    pose.poseIsValid = true;
+    pose.willDriftInYaw = true;
+    pose.shouldApplyHeadModel = true;
+    pose.deviceIsConnected = true;
+
+    return pose;
+}
+
+vr::DriverPose_t makePoseTemplate()
+{
+    vr::DriverPose_t pose = {};
+    pose.qWorldFromDriverRotation.w = 1.0;
+    pose.qDriverFromHeadRotation.w = 1.0;
+    pose.qRotation.w = 1.0;
+    pose.result = vr::TrackingResult_Running_OK;
+    pose.poseIsValid = true;
+    pose.willDriftInYaw = true;
+    pose.shouldApplyHeadModel = true;
+    pose.deviceIsConnected = true;
+    return pose;
+}
+
+std::vector<OSVR_PoseReport> makeReports()
+{
+    std::vector<OSVR_PoseReport> reports(NUM_REPORTS);
+    for (size_t i = 0; i < NUM_REPORTS; ++i) {
+        const auto t = static_cast<double>(i) / NUM_REPORTS;
+        const Eigen::Quaterniond rotation(Eigen::AngleAxisd(t, Eigen::Vector3d(0.2, 1.0, 0.1).normalized()));
+        reports[i].sensor = 0;
+        osvr::util::vecMap(reports[i].pose.translation) = Eigen::Vector3d(t, 1.5 + t, -t);
+        osvr::util::toQuat(rotation, reports[i].pose.rotation);
+    }
+    return reports;
+}
+
+template <typename Convert>
+double nanosecondsPerReport(const std::vector<OSVR_PoseReport>& reports, std::vector<vr::DriverPose_t>& poses, Convert convert)
+{
+    const auto start = Clock::now();
+    for (size_t pass = 0; pass < NUM_PASSES; ++pass) {
+        for (size_t i = 0; i < reports.size(); ++i) {
+            poses[i] = convert(reports[i]);
+        }
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    return static_cast<double>(elapsed) / static_cast<double>(NUM_PASSES * reports.size());
+}
+
+} // end anonymous namespace
+
+int main()
+{
+    const auto reports = makeReports();
+    const auto pose_template = makePoseTemplate();
+    std::vector<vr::DriverPose_t> legacy_poses(reports.size());
+    std::vector<vr::DriverPose_t> poses(reports.size());
+
+    const auto legacy_ns = nanosecondsPerReport(reports, legacy_poses, &legacyConvertPose);
+    const auto template_ns = nanosecondsPerReport(reports, poses, [&pose_template](const OSVR_PoseReport& report) {
+        return convertPose(pose_template, report);
+    });
+
+    // Both conversions must produce the same poses
+    size_t mismatches = 0;
+    for (size_t i = 0; i < reports.size(); ++i) {
+        if (0 != std::memcmp(legacy_poses[i].vecPosition, poses[i].vecPosition, sizeof(poses[i].vecPosition))
+            || 0 != std::memcmp(&legacy_poses[i].qRotation, &poses[i].qRotation, sizeof(poses[i].qRotation)))
+            ++mismatches;
+    }
+
+    std::cout << "Eigen conversion: " << legacy_ns << " ns/report" << std::endl;
+    std::cout << "Template conversion: " << template_ns << " ns/report" << std::endl;
+    std::cout << "Mismatched poses: " << mismatches << std::endl;
+
+    return (0 == mismatches) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
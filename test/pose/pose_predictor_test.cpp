@@ -0,0 +1,181 @@
+/** @file
+    @brief Tests for PosePredictor against synthetic tracker reports.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <PosePredictor.h>
+#include "TestHelpers.h"
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+#include <osvr/Util/TimeValueC.h>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+// Standard includes
+#include <cstdint>
+#include <string>
+
+namespace {
+
+using test::check;
+
+// Reports arrive at 1 kHz
+const double REPORT_PERIOD = 0.001; // seconds
+const int NUM_REPORTS = 20;
+
+OSVR_TimeValue makeTimestamp(int report)
+{
+    OSVR_TimeValue timestamp;
+    timestamp.seconds = 1000;
+    timestamp.microseconds = static_cast<int32_t>(report * REPORT_PERIOD * 1e6);
+    return timestamp;
+}
+
+vr::DriverPose_t makePose(const Eigen::Vector3d& position, const Eigen::Quaterniond& orientation)
+{
+    vr::DriverPose_t pose = {};
+    Eigen::Vector3d::Map(pose.vecPosition) = position;
+    pose.qRotation.w = orientation.w();
+    pose.qRotation.x = orientation.x();
+    pose.qRotation.y = orientation.y();
+    pose.qRotation.z = orientation.z();
+    return pose;
+}
+
+bool near(const double* actual, const Eigen::Vector3d& expected, double tolerance = 1e-6)
+{
+    return (Eigen::Vector3d::Map(actual) - expected).norm() < tolerance;
+}
+
+void testConstantVelocity()
+{
+    PosePredictor predictor;
+    const Eigen::Vector3d start(0.1, 1.5, -0.2);
+    const Eigen::Vector3d velocity(0.5, 0.0, -1.0);
+
+    vr::DriverPose_t pose;
+    for (int i = 0; i < NUM_REPORTS; ++i) {
+        pose = makePose(start + velocity * (i * REPORT_PERIOD), Eigen::Quaterniond::Identity());
+        predictor.update(makeTimestamp(i), pose);
+    }
+
+    check(near(pose.vecVelocity, velocity), "constant velocity: the velocity is recovered with its sign");
+    check(near(pose.vecAcceleration, Eigen::Vector3d::Zero()), "constant velocity: there's no acceleration");
+    check(near(pose.vecAngularVelocity, Eigen::Vector3d::Zero()), "constant velocity: there's no angular velocity");
+}
+
+void testConstantAcceleration()
+{
+    PosePredictor predictor;
+    const Eigen::Vector3d acceleration(0.0, -9.8, 2.0);
+
+    vr::DriverPose_t pose;
+    for (int i = 0; i < NUM_REPORTS; ++i) {
+        const auto t = i * REPORT_PERIOD;
+        pose = makePose(0.5 * acceleration * t * t, Eigen::Quaterniond::Identity());
+        predictor.update(makeTimestamp(i), pose);
+    }
+
+    const auto t = (NUM_REPORTS - 1) * REPORT_PERIOD;
+    check(near(pose.vecVelocity, acceleration * t), "constant acceleration: the velocity is the one at the newest report");
+    check(near(pose.vecAcceleration, acceleration, 1e-4), "constant acceleration: the acceleration is recovered");
+}
+
+void testConstantAngularRate()
+{
+    PosePredictor predictor;
+
+    // Yawed 90 degrees so that the device's axes differ from the tracking
+    // frame's, spinning counterclockwise about its own z (forward is -z).
+    const Eigen::Quaterniond start(Eigen::AngleAxisd(0.5 * 3.14159265358979323846, Eigen::Vector3d::UnitY()));
+    const Eigen::Vector3d angular_velocity(0.0, 0.0, 2.0); // radians/second
+
+    vr::DriverPose_t pose;
+    Eigen::Quaterniond orientation;
+    for (int i = 0; i < NUM_REPORTS; ++i) {
+        const auto t = i * REPORT_PERIOD;
+        orientation = start * Eigen::Quaterniond(Eigen::AngleAxisd(angular_velocity.norm() * t, angular_velocity.normalized()));
+        pose = makePose(Eigen::Vector3d::Zero(), orientation);
+        predictor.update(makeTimestamp(i), pose);
+    }
+
+    check(near(pose.vecAngularVelocity, angular_velocity), "constant angular rate: the rate is about the device's own axes");
+    check(!near(pose.vecAngularVelocity, orientation * angular_velocity), "constant angular rate: the rate isn't in the tracking frame");
+    check(near(pose.vecAngularAcceleration, Eigen::Vector3d::Zero(), 1e-4), "constant angular rate: there's no angular acceleration");
+    check(near(pose.vecVelocity, Eigen::Vector3d::Zero()), "constant angular rate: there's no linear velocity");
+
+    // Spinning the other way flips the sign
+    PosePredictor reversed;
+    for (int i = 0; i < NUM_REPORTS; ++i) {
+        const auto t = i * REPORT_PERIOD;
+        pose = makePose(Eigen::Vector3d::Zero(), start * Eigen::Quaterniond(Eigen::AngleAxisd(-angular_velocity.norm() * t, angular_velocity.normalized())));
+        reversed.update(makeTimestamp(i), pose);
+    }
+    check(near(pose.vecAngularVelocity, -angular_velocity), "constant angular rate: clockwise spin is negative");
+}
+
+void testOutOfOrderReports()
+{
+    PosePredictor predictor;
+    const Eigen::Vector3d velocity(1.0, 0.0, 0.0);
+
+    vr::DriverPose_t pose;
+    for (int i = 0; i < NUM_REPORTS; ++i) {
+        pose = makePose(velocity * (i * REPORT_PERIOD), Eigen::Quaterniond::Identity());
+        predictor.update(makeTimestamp(i), pose);
+    }
+
+    // A report older than the newest one starts the history over
+    pose = makePose(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+    predictor.update(makeTimestamp(0), pose);
+    check(near(pose.vecVelocity, Eigen::Vector3d::Zero()), "out-of-order report: no velocity from a single sample");
+}
+
+void testStaleHistory()
+{
+    PosePredictor predictor;
+
+    // Two reports further apart than the history window
+    vr::DriverPose_t pose = makePose(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+    predictor.update(makeTimestamp(0), pose);
+    pose = makePose(Eigen::Vector3d(1.0, 0.0, 0.0), Eigen::Quaterniond::Identity());
+    predictor.update(makeTimestamp(500), pose);
+    check(near(pose.vecVelocity, Eigen::Vector3d::Zero()), "stale history: old reports aren't fit against");
+}
+
+} // end anonymous namespace
+
+int main()
+{
+    testConstantVelocity();
+    testConstantAcceleration();
+    testConstantAngularRate();
+    testOutOfOrderReports();
+    testStaleHistory();
+
+    return test::finish();
+}
@@ -0,0 +1,138 @@
+/** @file
+    @brief Stress test for the seqlock that stores tracked device poses.
+
+    Several writer threads publish poses the way the tracker callbacks do
+    while several reader threads call load() the way GetPose() does. Every
+    field of each published pose is derived from a single counter, so a torn
+    read shows up as a pose whose fields disagree.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <SeqLock.h>
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+// Standard includes
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int NUM_WRITERS = 2;
+const int NUM_READERS = 4;
+const uint64_t POSES_PER_WRITER = 1000000;
+
+vr::DriverPose_t makePose(uint64_t n)
+{
+    const auto value = static_cast<double>(n);
+
+    vr::DriverPose_t pose = {};
+    pose.poseTimeOffset = value;
+    pose.qWorldFromDriverRotation = { value, value, value, value };
+    pose.qDriverFromHeadRotation = { value, value, value, value };
+    pose.qRotation = { value, value, value, value };
+    for (int i = 0; i < 3; ++i) {
+        pose.vecWorldFromDriverTranslation[i] = value;
+        pose.vecDriverFromHeadTranslation[i] = value;
+        pose.vecPosition[i] = value;
+        pose.vecVelocity[i] = value;
+        pose.vecAcceleration[i] = value;
+        pose.vecAngularVelocity[i] = value;
+        pose.vecAngularAcceleration[i] = value;
+    }
+    pose.result = (n % 2) ? vr::TrackingResult_Running_OK : vr::TrackingResult_Uninitialized;
+    pose.poseIsValid = (n % 2) != 0;
+    pose.deviceIsConnected = (n % 2) != 0;
+    return pose;
+}
+
+bool isConsistent(const vr::DriverPose_t& pose)
+{
+    const auto value = pose.poseTimeOffset;
+    const auto odd = (static_cast<uint64_t>(value) % 2) != 0;
+
+    const auto quat_ok = [value](const vr::HmdQuaternion_t& q) {
+        return q.w == value && q.x == value && q.y == value && q.z == value;
+    };
+    if (!quat_ok(pose.qWorldFromDriverRotation) || !quat_ok(pose.qDriverFromHeadRotation) || !quat_ok(pose.qRotation))
+        return false;
+
+    for (int i = 0; i < 3; ++i) {
+        if (pose.vecWorldFromDriverTranslation[i] != value || pose.vecDriverFromHeadTranslation[i] != value
+            || pose.vecPosition[i] != value || pose.vecVelocity[i] != value || pose.vecAcceleration[i] != value
+            || pose.vecAngularVelocity[i] != value || pose.vecAngularAcceleration[i] != value)
+            return false;
+    }
+
+    return pose.poseIsValid == odd && pose.deviceIsConnected == odd
+        && pose.result == (odd ? vr::TrackingResult_Running_OK : vr::TrackingResult_Uninitialized);
+}
+
+} // end anonymous namespace
+
+int main()
+{
+    SeqLock<vr::DriverPose_t> pose(makePose(0));
+
+    std::atomic<int> writers_running { NUM_WRITERS };
+    std::atomic<uint64_t> torn_reads { 0 };
+    std::atomic<uint64_t> reads { 0 };
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < NUM_WRITERS; ++w) {
+        threads.emplace_back([&, w] {
+            for (uint64_t i = 0; i < POSES_PER_WRITER; ++i) {
+                pose.store(makePose(i * NUM_WRITERS + w));
+            }
+            --writers_running;
+        });
+    }
+
+    for (int r = 0; r < NUM_READERS; ++r) {
+        threads.emplace_back([&] {
+            uint64_t local_reads = 0;
+            uint64_t local_torn = 0;
+            while (writers_running > 0) {
+                if (!isConsistent(pose.load()))
+                    ++local_torn;
+                ++local_reads;
+            }
+            reads += local_reads;
+            torn_reads += local_torn;
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::cout << "Writes: " << NUM_WRITERS * POSES_PER_WRITER << ", reads: " << reads << ", torn reads: " << torn_reads << std::endl;
+
+    return (0 == torn_reads) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,285 @@
+/** @file
+    @brief Stress test for the tracked device pose path.
+
+    Feeds tracker reports through OSVRTrackedDevice::trackerCallback() while
+    other threads call GetPose() and runFrame(), the way the OSVR client and
+    SteamVR do, and checks that every pose read or published is one that was
+    reported, whole, and in order. Covers direct delivery and delivery
+    through the triple buffer, both for pose coalescing and for a maximum
+    pose update rate on its own.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <OSVRTrackedDevice.h>
+#include <osvr_compiler_detection.h>
+#include "StubDriverHost.h"
+#include "TestHelpers.h"
+
+// Library/third-party includes
+#include <openvr_driver.h>
+
+#include <osvr/ClientKit/Context.h>
+#include <osvr/Util/ClientReportTypesC.h>
+#include <osvr/Util/TimeValueC.h>
+
+// Standard includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using test::check;
+
+const int NUM_READERS = 4;
+const uint64_t NUM_REPORTS = 1000000;
+const int32_t MAX_POSE_UPDATE_RATE = 1000;
+
+vr::DriverPose_t makeReportedPose(uint64_t n);
+bool isConsistent(const vr::DriverPose_t& pose);
+uint64_t getSequence(const vr::DriverPose_t& pose);
+
+/**
+ * Stands in for SteamVR, checking each pose the device publishes.
+ */
+class PoseCheckingHost : public test::StubDriverHost {
+public:
+    PoseCheckingHost(bool pose_coalescing, int32_t max_pose_update_rate)
+    {
+        settings().setBool("poseCoalescing", pose_coalescing);
+        settings().setInt32("maxPoseUpdateRateHz", max_pose_update_rate);
+    }
+
+    void TrackedDevicePoseUpdated(uint32_t, const vr::DriverPose_t& pose) OSVR_OVERRIDE
+    {
+        if (!isConsistent(pose)) {
+            ++tornPoses;
+            return;
+        }
+
+        // Poses are published from one thread at a time, newest last
+        const auto sequence = getSequence(pose);
+        if (sequence <= lastPublished)
+            ++outOfOrderPoses;
+        lastPublished = sequence;
+        ++published;
+    }
+
+    std::atomic<uint64_t> published { 0 };
+    std::atomic<uint64_t> tornPoses { 0 };
+    std::atomic<uint64_t> outOfOrderPoses { 0 };
+    std::atomic<uint64_t> lastPublished { 0 };
+};
+
+/**
+ * Exposes the tracker callback, which the device normally registers with
+ * the OSVR client itself.
+ */
+class TestDevice : public OSVRTrackedDevice {
+public:
+    TestDevice(osvr::clientkit::ClientContext& context, vr::IServerDriverHost* driver_host) : OSVRTrackedDevice(context, driver_host, vr::TrackedDeviceClass_TrackingReference)
+    {
+        // do nothing
+    }
+
+    void report(uint64_t n)
+    {
+        OSVR_TimeValue timestamp;
+        timestamp.seconds = static_cast<OSVR_TimeValue_Seconds>(n / 1000000);
+        timestamp.microseconds = static_cast<OSVR_TimeValue_Microseconds>(n % 1000000);
+
+        const auto pose = makeReportedPose(n);
+        OSVR_PoseReport report;
+        report.sensor = 0;
+        report.pose.translation.data[0] = pose.vecPosition[0];
+        report.pose.translation.data[1] = pose.vecPosition[1];
+        report.pose.translation.data[2] = pose.vecPosition[2];
+        report.pose.rotation.data[0] = pose.qRotation.w;
+        report.pose.rotation.data[1] = pose.qRotation.x;
+        report.pose.rotation.data[2] = pose.qRotation.y;
+        report.pose.rotation.data[3] = pose.qRotation.z;
+
+        trackerCallback<OSVR_PoseReport>(this, &timestamp, &report);
+    }
+};
+
+/**
+ * Encodes report @p n (counting from 1) in every tracked field, so a pose
+ * stitched together from two reports is detectable. Not a unit quaternion,
+ * but nothing on this path normalizes it.
+ */
+vr::DriverPose_t makeReportedPose(uint64_t n)
+{
+    const auto value = static_cast<double>(n);
+
+    vr::DriverPose_t pose = {};
+    pose.vecPosition[0] = value;
+    pose.vecPosition[1] = -value;
+    pose.vecPosition[2] = 2.0 * value;
+    pose.qRotation = { value, -value, 3.0 * value, 0.5 * value };
+    return pose;
+}
+
+uint64_t getSequence(const vr::DriverPose_t& pose)
+{
+    return static_cast<uint64_t>(pose.vecPosition[0]);
+}
+
+/**
+ * Returns @c true for the pose the device starts out with and for whole
+ * reported poses.
+ */
+bool isConsistent(const vr::DriverPose_t& pose)
+{
+    const auto sequence = getSequence(pose);
+    if (0 == sequence)
+        return !pose.poseIsValid && vr::TrackingResult_Uninitialized == pose.result;
+
+    const auto expected = makeReportedPose(sequence);
+    for (int i = 0; i < 3; ++i) {
+        if (pose.vecPosition[i] != expected.vecPosition[i])
+            return false;
+    }
+
+    return pose.qRotation.w == expected.qRotation.w && pose.qRotation.x == expected.qRotation.x
+        && pose.qRotation.y == expected.qRotation.y && pose.qRotation.z == expected.qRotation.z
+        && pose.poseIsValid && pose.deviceIsConnected && vr::TrackingResult_Running_OK == pose.result;
+}
+
+std::string getPoseStats(OSVRTrackedDevice& device)
+{
+    char buffer[256];
+    device.DebugRequest("pose_stats", buffer, sizeof(buffer));
+    return buffer;
+}
+
+void runStress(osvr::clientkit::ClientContext& context, bool pose_coalescing, int32_t max_pose_update_rate)
+{
+    const auto queued = pose_coalescing || max_pose_update_rate > 0;
+    const std::string mode = pose_coalescing ? "coalesced" : (queued ? "rate limited" : "direct");
+
+    PoseCheckingHost host(pose_coalescing, max_pose_update_rate);
+    TestDevice device(context, &host);
+    device.Activate(0);
+
+    std::atomic<bool> reporting { true };
+    std::atomic<uint64_t> reads { 0 };
+    std::atomic<uint64_t> torn_reads { 0 };
+    std::atomic<uint64_t> stale_reads { 0 };
+
+    std::vector<std::thread> threads;
+
+    // OSVR delivers a device's reports from one thread: the client update
+    // thread, or SteamVR's when there isn't one. The triple buffer relies on
+    // there being a single writer.
+    threads.emplace_back([&] {
+        for (uint64_t n = 1; n <= NUM_REPORTS; ++n) {
+            device.report(n);
+        }
+        reporting = false;
+    });
+
+    // SteamVR's RunFrame(), which delivers queued poses. The device needs
+    // no context to activate, so report it as up.
+    threads.emplace_back([&] {
+        while (reporting) {
+            device.runFrame(true);
+        }
+    });
+
+    // SteamVR reading poses from its own threads
+    for (int r = 0; r < NUM_READERS; ++r) {
+        threads.emplace_back([&] {
+            uint64_t local_reads = 0;
+            uint64_t local_torn = 0;
+            uint64_t local_stale = 0;
+            uint64_t last_sequence = 0;
+            while (reporting) {
+                const auto pose = device.GetPose();
+                if (!isConsistent(pose)) {
+                    ++local_torn;
+                } else {
+                    const auto sequence = getSequence(pose);
+                    if (sequence < last_sequence)
+                        ++local_stale;
+                    last_sequence = sequence;
+                }
+                ++local_reads;
+            }
+            reads += local_reads;
+            torn_reads += local_torn;
+            stale_reads += local_stale;
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Deliver whatever is still queued once it's due
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    device.runFrame(true);
+
+    const auto published = host.published.load();
+    std::cout << mode << ": reports: " << NUM_REPORTS << ", published: " << published << ", reads: " << reads.load()
+              << ", torn reads: " << torn_reads.load() << std::endl;
+
+    check(0 == torn_reads, mode + ": GetPose() never returns a torn pose");
+    check(0 == stale_reads, mode + ": GetPose() never goes back to an older pose");
+    check(0 == host.tornPoses, mode + ": SteamVR is never sent a torn pose");
+    check(0 == host.outOfOrderPoses, mode + ": SteamVR is sent poses in order");
+    check(NUM_REPORTS == host.lastPublished, mode + ": the newest report is published");
+    check(NUM_REPORTS == getSequence(device.GetPose()), mode + ": GetPose() returns the newest report");
+    if (queued) {
+        check(published <= NUM_REPORTS, mode + ": no report is published twice");
+    } else {
+        check(NUM_REPORTS == published, mode + ": every report is published");
+    }
+
+    const auto expected_stats = "received=" + std::to_string(NUM_REPORTS) + " published=" + std::to_string(published)
+        + " dropped=" + std::to_string(NUM_REPORTS - published);
+    check(expected_stats == getPoseStats(device), mode + ": every report is counted as published or dropped");
+
+    device.Deactivate();
+}
+
+} // end anonymous namespace
+
+int main()
+{
+    // Never updated: the device only holds on to it
+    osvr::clientkit::ClientContext context("org.osvr.test.pose");
+
+    runStress(context, false, 0);
+    runStress(context, true, 0);
+    // Without coalescing, the rate limit alone has to queue poses
+    runStress(context, false, MAX_POSE_UPDATE_RATE);
+
+    return test::finish();
+}
@@ -0,0 +1,167 @@
+/** @file
+    @brief Benchmark for the tracked device property getters.
+
+    Compares lookups in the dense PropertyStore against the std::map of
+    boost::variant values it replaced, using the properties an HMD sets.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <PropertyStore.h>
+
+// Library/third-party includes
+#include <boost/variant.hpp>
+
+#include <openvr_driver.h>
+
+// Standard includes
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t NUM_PASSES = 200000;
+
+using Clock = std::chrono::steady_clock;
+
+using Property = boost::variant<bool, float, int32_t, uint64_t, vr::HmdMatrix34_t, uint32_t, std::string>;
+using PropertyMap = std::map<vr::ETrackedDeviceProperty, Property>;
+
+const vr::ETrackedDeviceProperty FLOAT_PROPERTIES[] = {
+    vr::Prop_SecondsFromVsyncToPhotons_Float,
+    vr::Prop_DisplayFrequency_Float,
+    vr::Prop_UserIpdMeters_Float,
+    vr::Prop_LensCenterLeftU_Float,
+    vr::Prop_LensCenterLeftV_Float,
+    vr::Prop_LensCenterRightU_Float,
+    vr::Prop_LensCenterRightV_Float,
+    vr::Prop_UserHeadToEyeDepthMeters_Float,
+};
+
+const vr::ETrackedDeviceProperty BOOL_PROPERTIES[] = {
+    vr::Prop_WillDriftInYaw_Bool,
+    vr::Prop_DeviceIsWireless_Bool,
+    vr::Prop_ContainsProximitySensor_Bool,
+    vr::Prop_ReportsTimeSinceVSync_Bool,
+    vr::Prop_IsOnDesktop_Bool,
+};
+
+const vr::ETrackedDeviceProperty STRING_PROPERTIES[] = {
+    vr::Prop_TrackingSystemName_String,
+    vr::Prop_ModelNumber_String,
+    vr::Prop_SerialNumber_String,
+    vr::Prop_ManufacturerName_String,
+};
+
+template <typename Function>
+double nanosecondsPerLookup(size_t lookups_per_pass, Function function)
+{
+    const auto start = Clock::now();
+    for (size_t pass = 0; pass < NUM_PASSES; ++pass) {
+        function();
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    return static_cast<double>(elapsed) / static_cast<double>(NUM_PASSES * lookups_per_pass);
+}
+
+/**
+ * Looks a property up the way OSVRTrackedDevice used to: find() followed by
+ * operator[].
+ */
+template <typename T>
+T mapLookup(PropertyMap& properties, vr::ETrackedDeviceProperty prop, const T& default_value)
+{
+    if (properties.find(prop) != end(properties)) {
+        return boost::get<T>(properties[prop]);
+    }
+    return default_value;
+}
+
+template <typename T>
+T storeLookup(PropertyStore& properties, vr::ETrackedDeviceProperty prop, const T& default_value)
+{
+    const auto value = properties.get<T>(prop);
+    return value ? *value : default_value;
+}
+
+} // end anonymous namespace
+
+int main()
+{
+    PropertyMap map_properties;
+    PropertyStore store_properties;
+
+    float float_value = 0.0f;
+    for (const auto prop : FLOAT_PROPERTIES) {
+        map_properties[prop] = float_value;
+        store_properties.set(prop, float_value);
+        float_value += 0.25f;
+    }
+    for (const auto prop : BOOL_PROPERTIES) {
+        map_properties[prop] = true;
+        store_properties.set(prop, true);
+    }
+    for (const auto prop : STRING_PROPERTIES) {
+        map_properties[prop] = std::string("OSVR HDK 2");
+        store_properties.set(prop, std::string("OSVR HDK 2"));
+    }
+
+    const size_t lookups_per_pass = sizeof(FLOAT_PROPERTIES) / sizeof(FLOAT_PROPERTIES[0])
+        + sizeof(BOOL_PROPERTIES) / sizeof(BOOL_PROPERTIES[0])
+        + sizeof(STRING_PROPERTIES) / sizeof(STRING_PROPERTIES[0]);
+
+    // Keep the results live so the lookups aren't optimized away
+    double map_sum = 0.0;
+    size_t map_length = 0;
+    const auto map_ns = nanosecondsPerLookup(lookups_per_pass, [&] {
+        for (const auto prop : FLOAT_PROPERTIES)
+            map_sum += mapLookup(map_properties, prop, 0.0f);
+        for (const auto prop : BOOL_PROPERTIES)
+            map_sum += mapLookup(map_properties, prop, false) ? 1.0 : 0.0;
+        for (const auto prop : STRING_PROPERTIES)
+            map_length += mapLookup(map_properties, prop, std::string()).size();
+    });
+
+    double store_sum = 0.0;
+    size_t store_length = 0;
+    const auto store_ns = nanosecondsPerLookup(lookups_per_pass, [&] {
+        for (const auto prop : FLOAT_PROPERTIES)
+            store_sum += storeLookup(store_properties, prop, 0.0f);
+        for (const auto prop : BOOL_PROPERTIES)
+            store_sum += storeLookup(store_properties, prop, false) ? 1.0 : 0.0;
+        for (const auto prop : STRING_PROPERTIES)
+            store_length += store_properties.get<std::string>(prop)->size();
+    });
+
+    std::cout << "std::map<boost::variant>: " << map_ns << " ns/lookup" << std::endl;
+    std::cout << "PropertyStore: " << store_ns << " ns/lookup" << std::endl;
+
+    const auto match = (map_sum == store_sum) && (map_length == store_length);
+    std::cout << "Results " << (match ? "match" : "DIFFER") << std::endl;
+
+    return match ? EXIT_SUCCESS : EXIT_FAILURE;
+}